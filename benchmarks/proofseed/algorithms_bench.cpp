@@ -0,0 +1,495 @@
+// clazy:skip
+
+#include "proofseed/algorithmviews.h"
+#include "proofseed/flathash.h"
+#include "proofseed/parallelalgorithms.h"
+#include "proofseed/proofalgorithms.h"
+#include "proofseed/vectorizedalgorithms.h"
+
+#include "benchmark/benchmark.h"
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QVector>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Proof;
+
+namespace {
+template <typename Container>
+Container sequentialContainer(long long size, long long modulo = 0)
+{
+    Container result;
+    algorithms::detail::reserveContainer(result, size);
+    for (long long i = 0; i < size; ++i)
+        algorithms::detail::addToContainer(result, static_cast<int>(modulo ? i % modulo : i));
+    return result;
+}
+
+QHash<int, int> sequentialHash(long long size)
+{
+    QHash<int, int> result;
+    result.reserve(static_cast<int>(size));
+    for (int i = 0; i < size; ++i)
+        result.insert(i, i);
+    return result;
+}
+} // namespace
+
+template <typename Container>
+static void bmMapInPlace(benchmark::State &state)
+{
+    Container container = sequentialContainer<Container>(state.range(0));
+    for (auto _ : state) {
+        algorithms::mapInPlace(container, [](int x) { return x + 1; });
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmMapInPlace, QVector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmMapInPlace, QList<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmMapInPlace, std::vector<int>)->Range(1 << 10, 1 << 20);
+
+template <typename Container>
+static void bmParallelMapInPlace(benchmark::State &state)
+{
+    Container container = sequentialContainer<Container>(state.range(0));
+    for (auto _ : state) {
+        algorithms::mapInPlace(algorithms::par, container, [](int x) { return x + 1; });
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmParallelMapInPlace, QVector<int>)->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK_TEMPLATE(bmParallelMapInPlace, std::vector<int>)->Range(1 << 10, 1 << 22)->UseRealTime();
+
+template <typename Container>
+static void bmForEach(benchmark::State &state)
+{
+    Container container = sequentialContainer<Container>(state.range(0));
+    for (auto _ : state) {
+        long long sum = 0;
+        algorithms::forEach(container, [&sum](int x) { sum += x; });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmForEach, QVector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmForEach, QList<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmForEach, std::vector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmForEach, QSet<int>)->Range(1 << 10, 1 << 20);
+
+static void bmForEachHash(benchmark::State &state)
+{
+    QHash<int, int> container = sequentialHash(state.range(0));
+    for (auto _ : state) {
+        long long sum = 0;
+        algorithms::forEach(container, [&sum](int key, int value) { sum += key + value; });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmForEachHash)->Range(1 << 10, 1 << 20);
+
+template <typename Container>
+static void bmEraseIf(benchmark::State &state)
+{
+    const Container source = sequentialContainer<Container>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container container = source;
+        algorithms::detail::beginIterator(container); // forces detach of implicitly shared containers outside timing
+        state.ResumeTiming();
+        algorithms::eraseIf(container, [](int x) { return x % 2; });
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmEraseIf, QVector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmEraseIf, QList<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmEraseIf, std::vector<int>)->Range(1 << 10, 1 << 20);
+
+template <typename Container>
+static void bmParallelEraseIf(benchmark::State &state)
+{
+    const Container source = sequentialContainer<Container>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container container = source;
+        algorithms::detail::beginIterator(container);
+        state.ResumeTiming();
+        algorithms::eraseIf(algorithms::par, container, [](int x) { return x % 2; });
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmParallelEraseIf, QVector<int>)->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK_TEMPLATE(bmParallelEraseIf, std::vector<int>)->Range(1 << 10, 1 << 22)->UseRealTime();
+
+static void bmEraseIfHash(benchmark::State &state)
+{
+    const QHash<int, int> source = sequentialHash(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        QHash<int, int> container = source;
+        benchmark::DoNotOptimize(container.begin());
+        state.ResumeTiming();
+        algorithms::eraseIf(container, [](int key, int) { return key % 2; });
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmEraseIfHash)->Range(1 << 10, 1 << 20);
+
+static void bmParallelEraseIfHash(benchmark::State &state)
+{
+    const QHash<int, int> source = sequentialHash(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        QHash<int, int> container = source;
+        benchmark::DoNotOptimize(container.begin());
+        state.ResumeTiming();
+        algorithms::eraseIf(algorithms::par, container, [](int key, int) { return key % 2; });
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmParallelEraseIfHash)->Range(1 << 10, 1 << 20)->UseRealTime();
+
+template <typename Container>
+static void bmMakeUnique(benchmark::State &state)
+{
+    Container source = sequentialContainer<Container>(state.range(0), 1 << 8);
+    std::sort(source.begin(), source.end());
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container container = source;
+        benchmark::DoNotOptimize(container.begin());
+        state.ResumeTiming();
+        algorithms::makeUnique(container);
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmMakeUnique, QVector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmMakeUnique, QList<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmMakeUnique, std::vector<int>)->Range(1 << 10, 1 << 20);
+
+template <typename Container>
+static void bmParallelMakeUnique(benchmark::State &state)
+{
+    Container source = sequentialContainer<Container>(state.range(0), 1 << 8);
+    std::sort(source.begin(), source.end());
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container container = source;
+        benchmark::DoNotOptimize(container.begin());
+        state.ResumeTiming();
+        algorithms::makeUnique(algorithms::par, container);
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmParallelMakeUnique, QVector<int>)->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK_TEMPLATE(bmParallelMakeUnique, std::vector<int>)->Range(1 << 10, 1 << 22)->UseRealTime();
+
+template <typename Container>
+static void bmSortAndMakeUnique(benchmark::State &state)
+{
+    const Container source = sequentialContainer<Container>(state.range(0), 1 << 8);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container container = source;
+        benchmark::DoNotOptimize(container.begin());
+        state.ResumeTiming();
+        std::sort(container.begin(), container.end());
+        algorithms::makeUnique(container);
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmSortAndMakeUnique, QVector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmSortAndMakeUnique, std::vector<int>)->Range(1 << 10, 1 << 20);
+
+template <typename Container>
+static void bmMakeDistinct(benchmark::State &state)
+{
+    const Container source = sequentialContainer<Container>(state.range(0), 1 << 8);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container container = source;
+        benchmark::DoNotOptimize(container.begin());
+        state.ResumeTiming();
+        algorithms::makeDistinct(container);
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmMakeDistinct, QVector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmMakeDistinct, std::vector<int>)->Range(1 << 10, 1 << 20);
+
+template <typename Container>
+static void bmToSet(benchmark::State &state)
+{
+    Container container = sequentialContainer<Container>(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::toSet(container));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmToSet, QVector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmToSet, QList<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmToSet, std::vector<int>)->Range(1 << 10, 1 << 20);
+
+template <typename Container>
+static void bmParallelToSet(benchmark::State &state)
+{
+    Container container = sequentialContainer<Container>(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::toSet(algorithms::par, container));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmParallelToSet, QVector<int>)->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK_TEMPLATE(bmParallelToSet, std::vector<int>)->Range(1 << 10, 1 << 22)->UseRealTime();
+
+static void bmToSetWithDuplicates(benchmark::State &state)
+{
+    QVector<int> container = sequentialContainer<QVector<int>>(state.range(0), state.range(0) / 16);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::toSet(container));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmToSetWithDuplicates)->Range(1 << 10, 1 << 22);
+
+static void bmParallelToSetWithDuplicates(benchmark::State &state)
+{
+    QVector<int> container = sequentialContainer<QVector<int>>(state.range(0), state.range(0) / 16);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::toSet(algorithms::par, container));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmParallelToSetWithDuplicates)->Range(1 << 10, 1 << 22)->UseRealTime();
+
+static void bmToFlatSet(benchmark::State &state)
+{
+    QVector<int> container = sequentialContainer<QVector<int>>(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::toFlatSet(container));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmToFlatSet)->Range(1 << 10, 1 << 20);
+
+// Half of lookups are misses, keys are visited in order unrelated to their placement
+template <typename Set>
+static void bmSetLookup(benchmark::State &state)
+{
+    const long long size = state.range(0);
+    Set set;
+    set.reserve(size);
+    for (long long i = 0; i < size; ++i)
+        set.insert(static_cast<int>(i * 2));
+    QVector<int> keys = sequentialContainer<QVector<int>>(size * 2);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+    for (auto _ : state) {
+        long long found = 0;
+        for (int key : keys)
+            found += set.contains(key);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * size * 2);
+}
+BENCHMARK_TEMPLATE(bmSetLookup, QSet<int>)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(bmSetLookup, FlatHashSet<int>)->Range(1 << 10, 1 << 22);
+
+static void bmToKeysSet(benchmark::State &state)
+{
+    QHash<int, int> container = sequentialHash(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::toKeysSet(container));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmToKeysSet)->Range(1 << 10, 1 << 20);
+
+static void bmParallelToKeysSet(benchmark::State &state)
+{
+    QHash<int, int> container = sequentialHash(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::toKeysSet(algorithms::par, container));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmParallelToKeysSet)->Range(1 << 10, 1 << 22)->UseRealTime();
+
+template <typename Container>
+static void bmFlatFilter(benchmark::State &state)
+{
+    Container container;
+    for (long long i = 0; i < state.range(0) / 16; ++i)
+        algorithms::detail::addToContainer(container, sequentialContainer<typename Container::value_type>(16));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(
+            algorithms::flatFilter(container, [](int x) { return x % 2; }, algorithms::ReserveMode::UpperBound));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmFlatFilter, QVector<QVector<int>>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmFlatFilter, QList<QList<int>>)->Range(1 << 10, 1 << 20);
+
+template <typename Container>
+static void bmParallelFlatFilter(benchmark::State &state)
+{
+    Container container;
+    for (long long i = 0; i < state.range(0) / 16; ++i)
+        algorithms::detail::addToContainer(container, sequentialContainer<typename Container::value_type>(16));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::flatFilter(algorithms::par, container, [](int x) { return x % 2; }));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmParallelFlatFilter, QVector<QVector<int>>)->Range(1 << 10, 1 << 22)->UseRealTime();
+BENCHMARK_TEMPLATE(bmParallelFlatFilter, QList<QList<int>>)->Range(1 << 10, 1 << 22)->UseRealTime();
+
+static void bmReduceCounts(benchmark::State &state)
+{
+    QVector<int> container = sequentialContainer<QVector<int>>(state.range(0));
+    for (auto _ : state) {
+        auto counts = algorithms::reduceByMutation(container, [](QHash<int, int> &acc, int x) { ++acc[x % 1024]; },
+                                                   QHash<int, int>());
+        benchmark::DoNotOptimize(counts);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmReduceCounts)->Range(1 << 10, 1 << 22)->UseRealTime();
+
+static void bmParallelReduceCounts(benchmark::State &state)
+{
+    QVector<int> container = sequentialContainer<QVector<int>>(state.range(0));
+    for (auto _ : state) {
+        auto counts = algorithms::reduceByMutation(
+            algorithms::par, container, [](QHash<int, int> &acc, int x) { ++acc[x % 1024]; }, QHash<int, int>(),
+            [](QHash<int, int> &left, QHash<int, int> &&right) {
+                for (auto it = right.cbegin(); it != right.cend(); ++it)
+                    left[it.key()] += it.value();
+            });
+        benchmark::DoNotOptimize(counts);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmParallelReduceCounts)->Range(1 << 10, 1 << 22)->UseRealTime();
+
+static void bmParallelReduceSum(benchmark::State &state)
+{
+    std::vector<long long> container = sequentialContainer<std::vector<long long>>(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::reduce(algorithms::par, container, algorithms::ops::Plus(), 0ll));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmParallelReduceSum)->Range(1 << 10, 1 << 24)->UseRealTime();
+
+template <typename T>
+static std::vector<T> arithmeticContainer(long long size)
+{
+    std::vector<T> result;
+    result.reserve(static_cast<size_t>(size));
+    for (long long i = 0; i < size; ++i)
+        result.push_back(static_cast<T>(i % 1000) / 10);
+    return result;
+}
+
+template <typename T>
+static void bmSumGeneric(benchmark::State &state)
+{
+    const std::vector<T> container = arithmeticContainer<T>(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::reduce(container, [](T acc, T x) { return acc + x; }, T(0)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmSumGeneric, float)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmSumGeneric, double)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmSumGeneric, int)->Range(1 << 10, 1 << 20);
+
+template <typename T>
+static void bmSumVectorized(benchmark::State &state)
+{
+    const std::vector<T> container = arithmeticContainer<T>(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::reduce(container, algorithms::ops::Plus(), T(0)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmSumVectorized, float)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmSumVectorized, double)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmSumVectorized, int)->Range(1 << 10, 1 << 20);
+
+template <typename T>
+static void bmThresholdFilterGeneric(benchmark::State &state)
+{
+    const std::vector<T> container = arithmeticContainer<T>(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::filter(container, [](T x) { return x > T(50); }));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmThresholdFilterGeneric, float)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmThresholdFilterGeneric, double)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmThresholdFilterGeneric, int)->Range(1 << 10, 1 << 20);
+
+template <typename T>
+static void bmThresholdFilterVectorized(benchmark::State &state)
+{
+    const std::vector<T> container = arithmeticContainer<T>(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(algorithms::filter(container, algorithms::ops::Greater<T>{T(50)}));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmThresholdFilterVectorized, float)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmThresholdFilterVectorized, double)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(bmThresholdFilterVectorized, int)->Range(1 << 10, 1 << 20);
+
+static void bmFilterMapToVectorEager(benchmark::State &state)
+{
+    QVector<int> container = sequentialContainer<QVector<int>>(state.range(0));
+    for (auto _ : state) {
+        auto filtered = algorithms::filter(container, [](int x) { return x % 3; });
+        auto mapped = algorithms::map(filtered, [](int x) { return x * 2ll; });
+        auto result = algorithms::map(mapped, [](long long x) { return x + 1; });
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmFilterMapToVectorEager)->Range(1 << 10, 1 << 20);
+
+static void bmFilterMapToVectorView(benchmark::State &state)
+{
+    QVector<int> container = sequentialContainer<QVector<int>>(state.range(0));
+    for (auto _ : state) {
+        auto result = algorithms::from(container) | algorithms::filtered([](int x) { return x % 3; })
+                      | algorithms::mapped([](int x) { return x * 2ll; })
+                      | algorithms::mapped([](long long x) { return x + 1; }) | algorithms::to<QVector>();
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmFilterMapToVectorView)->Range(1 << 10, 1 << 20);
+
+static void bmFilterMapToSetEager(benchmark::State &state)
+{
+    QVector<int> container = sequentialContainer<QVector<int>>(state.range(0));
+    for (auto _ : state) {
+        auto result = algorithms::toSet(algorithms::map(algorithms::filter(container, [](int x) { return x % 3; }),
+                                                        [](int x) { return x / 4; }));
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmFilterMapToSetEager)->Range(1 << 10, 1 << 20);
+
+static void bmFilterMapToSetView(benchmark::State &state)
+{
+    QVector<int> container = sequentialContainer<QVector<int>>(state.range(0));
+    for (auto _ : state) {
+        auto result = algorithms::from(container) | algorithms::filtered([](int x) { return x % 3; })
+                      | algorithms::mapped([](int x) { return x / 4; }) | algorithms::to<QSet>();
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmFilterMapToSetView)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,72 @@
+// clazy:skip
+
+#include "proofseed/asynqro_extra.h"
+
+#include "benchmark/benchmark.h"
+
+using namespace Proof;
+
+static void bmFailureEmpty(benchmark::State &state)
+{
+    for (auto _ : state) {
+        Failure failure;
+        benchmark::DoNotOptimize(failure);
+    }
+}
+BENCHMARK(bmFailureEmpty);
+
+static void bmFailureConstruction(benchmark::State &state)
+{
+    for (auto _ : state) {
+        Failure failure(QStringLiteral("Something went wrong"), 1, 2, Failure::UserFriendlyHint);
+        benchmark::DoNotOptimize(failure);
+    }
+}
+BENCHMARK(bmFailureConstruction);
+
+static void bmFailureCopy(benchmark::State &state)
+{
+    const Failure source(QStringLiteral("Something went wrong"), 1, 2, Failure::UserFriendlyHint, 42);
+    for (auto _ : state) {
+        Failure failure = source;
+        benchmark::DoNotOptimize(failure);
+    }
+}
+BENCHMARK(bmFailureCopy);
+
+static void bmFailureMove(benchmark::State &state)
+{
+    Failure source(QStringLiteral("Something went wrong"), 1, 2, Failure::UserFriendlyHint, 42);
+    for (auto _ : state) {
+        Failure failure = std::move(source);
+        source = std::move(failure);
+        benchmark::DoNotOptimize(source);
+    }
+}
+BENCHMARK(bmFailureMove);
+
+static void bmFailureWithCode(benchmark::State &state)
+{
+    const Failure source(QStringLiteral("Something went wrong"), 1, 2, Failure::UserFriendlyHint, 42);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(source.withCode(3, 4));
+}
+BENCHMARK(bmFailureWithCode);
+
+static void bmFailureWithChain(benchmark::State &state)
+{
+    for (auto _ : state) {
+        Failure failure = Failure(QStringLiteral("Something went wrong"), 1, 2).withCode(3, 4).withData(42);
+        benchmark::DoNotOptimize(failure);
+    }
+}
+BENCHMARK(bmFailureWithChain);
+
+static void bmFailedFuture(benchmark::State &state)
+{
+    for (auto _ : state) {
+        Future<int> future = Future<int>::failed(Failure(QStringLiteral("Something went wrong"), 1, 2));
+        benchmark::DoNotOptimize(future.failureReason());
+    }
+}
+BENCHMARK(bmFailedFuture);
@@ -0,0 +1,126 @@
+// clazy:skip
+
+#include "proofseed/asynqro_extra.h"
+#include "proofseed/readyfuture.h"
+
+#include "benchmark/benchmark.h"
+
+#include <QHash>
+#include <QSharedPointer>
+
+#include <vector>
+
+using namespace Proof;
+
+static void bmSequenceCompleted(benchmark::State &state)
+{
+    std::vector<Future<int>> futures;
+    for (long long i = 0; i < state.range(0); ++i)
+        futures.push_back(futures::successful(static_cast<int>(i)));
+    for (auto _ : state) {
+        Future<std::vector<int>> result = futures::sequence(futures);
+        benchmark::DoNotOptimize(result.resultRef());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmSequenceCompleted)->Range(1 << 4, 1 << 17);
+
+static void bmSequenceSharedCompleted(benchmark::State &state)
+{
+    auto futures = QSharedPointer<std::vector<Future<int>>>::create();
+    for (long long i = 0; i < state.range(0); ++i)
+        futures->push_back(futures::successful(static_cast<int>(i)));
+    for (auto _ : state) {
+        Future<std::vector<int>> result = futures::sequence(futures);
+        benchmark::DoNotOptimize(result.resultRef());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmSequenceSharedCompleted)->Range(1 << 4, 1 << 17);
+
+static void bmSequencePending(benchmark::State &state)
+{
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<Promise<int>> promises(static_cast<size_t>(state.range(0)));
+        std::vector<Future<int>> futures;
+        futures.reserve(promises.size());
+        for (const auto &promise : promises)
+            futures.push_back(promise.future());
+        state.ResumeTiming();
+        Future<std::vector<int>> result = futures::sequence(std::move(futures));
+        for (size_t i = 0; i < promises.size(); ++i)
+            promises[i].success(static_cast<int>(i));
+        benchmark::DoNotOptimize(result.resultRef());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmSequencePending)->Range(1 << 4, 1 << 17);
+
+static void bmSequenceWithFailures(benchmark::State &state)
+{
+    std::vector<Future<int>> futures;
+    for (long long i = 0; i < state.range(0); ++i) {
+        futures.push_back(i % 4 ? futures::successful(static_cast<int>(i))
+                                : Future<int>::failed(Failure("failed", 0, 0)));
+    }
+    for (auto _ : state) {
+        auto result = futures::sequenceWithFailures(futures);
+        benchmark::DoNotOptimize(result.resultRef());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmSequenceWithFailures)->Range(1 << 4, 1 << 17);
+
+static void bmSuccessfulMapChain(benchmark::State &state)
+{
+    for (auto _ : state) {
+        Future<int> result = futures::successful(1)
+                                 .map([](int x) { return x + 1; })
+                                 .map([](int x) { return x * 2; })
+                                 .flatMap([](int x) { return futures::successful(x - 1); });
+        benchmark::DoNotOptimize(result.resultRef());
+    }
+}
+BENCHMARK(bmSuccessfulMapChain);
+
+static void bmReadyMapChain(benchmark::State &state)
+{
+    for (auto _ : state) {
+        ReadyFuture<int> result = futures::ready(1)
+                                      .map([](int x) { return x + 1; })
+                                      .map([](int x) { return x * 2; })
+                                      .flatMap([](int x) { return futures::ready(x - 1); });
+        benchmark::DoNotOptimize(result.resultRef());
+    }
+}
+BENCHMARK(bmReadyMapChain);
+
+using CountdownResult = RepeaterResult<long long, long long, long long>;
+
+static CountdownResult countdown(long long left, long long sum)
+{
+    if (!left)
+        return repeater::Finish<long long>(sum);
+    return repeater::Continue<long long, long long>(left - 1, sum + left);
+}
+
+static void bmRepeatCompleted(benchmark::State &state)
+{
+    for (auto _ : state) {
+        Future<long long> result = futures::repeat<long long>(&countdown, state.range(0), 0ll);
+        benchmark::DoNotOptimize(result.resultRef());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmRepeatCompleted)->Range(1 << 4, 1 << 16);
+
+static void bmLoopCompleted(benchmark::State &state)
+{
+    for (auto _ : state) {
+        Future<long long> result = futures::loop<long long>(&countdown, state.range(0), 0ll);
+        benchmark::DoNotOptimize(result.resultRef());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmLoopCompleted)->Range(1 << 4, 1 << 16);
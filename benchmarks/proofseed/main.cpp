@@ -0,0 +1,26 @@
+#include "benchmark/benchmark.h"
+
+#include <QCoreApplication>
+
+#include <cstring>
+#include <vector>
+
+// JSON is used by default to make results diffable between releases, can be overridden with --benchmark_format
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    std::vector<char *> args(argv, argv + argc);
+    bool formatSpecified = false;
+    for (int i = 1; i < argc; ++i)
+        formatSpecified = formatSpecified || !std::strncmp(argv[i], "--benchmark_format", 18);
+    char jsonFormat[] = "--benchmark_format=json";
+    if (!formatSpecified)
+        args.push_back(jsonFormat);
+    int benchmarkArgc = static_cast<int>(args.size());
+    benchmark::Initialize(&benchmarkArgc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(benchmarkArgc, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,183 @@
+// clazy:skip
+
+#include "proofseed/asynqro_extra.h"
+#include "proofseed/memorypool.h"
+#include "proofseed/uniquefunction.h"
+
+#include "benchmark/benchmark.h"
+
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+using namespace Proof;
+
+static void bmRunLatency(benchmark::State &state)
+{
+    for (auto _ : state) {
+        Future<int> result = tasks::run([]() { return 42; });
+        benchmark::DoNotOptimize(result.result());
+    }
+}
+BENCHMARK(bmRunLatency)->UseRealTime();
+
+static void bmRunThroughput(benchmark::State &state)
+{
+    for (auto _ : state) {
+        std::vector<Future<int>> results;
+        results.reserve(static_cast<size_t>(state.range(0)));
+        for (long long i = 0; i < state.range(0); ++i)
+            results.push_back(tasks::run([i]() { return static_cast<int>(i); }));
+        for (const auto &result : results)
+            result.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmRunThroughput)->Range(1 << 8, 1 << 16)->UseRealTime();
+
+static void bmRunAndForgetThroughput(benchmark::State &state)
+{
+    for (auto _ : state) {
+        std::atomic<long long> left{state.range(0)};
+        Promise<bool> done;
+        for (long long i = 0; i < state.range(0); ++i) {
+            tasks::runAndForget([&left, done]() {
+                if (!--left)
+                    done.success(true);
+            });
+        }
+        done.future().wait();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmRunAndForgetThroughput)->Range(1 << 8, 1 << 16)->UseRealTime();
+
+static void bmRunAndForgetThroughputWithMetrics(benchmark::State &state)
+{
+    tasks::TasksMetrics::setEnabled(true);
+    for (auto _ : state) {
+        std::atomic<long long> left{state.range(0)};
+        Promise<bool> done;
+        for (long long i = 0; i < state.range(0); ++i) {
+            tasks::runAndForget([&left, done]() {
+                if (!--left)
+                    done.success(true);
+            });
+        }
+        done.future().wait();
+    }
+    tasks::TasksMetrics::setEnabled(false);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmRunAndForgetThroughputWithMetrics)->Range(1 << 8, 1 << 16)->UseRealTime();
+
+static void bmRunAndForgetThroughputWorkStealing(benchmark::State &state)
+{
+    tasks::WorkStealingPool::setScheduling(tasks::Scheduling::WorkStealing);
+    for (auto _ : state) {
+        std::atomic<long long> left{state.range(0)};
+        Promise<bool> done;
+        for (long long i = 0; i < state.range(0); ++i) {
+            tasks::runAndForget([&left, done]() {
+                if (!--left)
+                    done.success(true);
+            });
+        }
+        done.future().wait();
+    }
+    tasks::WorkStealingPool::setScheduling(tasks::Scheduling::SharedQueue);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmRunAndForgetThroughputWorkStealing)->Range(1 << 8, 1 << 16)->UseRealTime();
+
+// Binary tree of tasks where every task is spawned by another task
+static void bmNestedRunAndForget(benchmark::State &state)
+{
+    const auto scheduling = state.range(1) ? tasks::Scheduling::WorkStealing : tasks::Scheduling::SharedQueue;
+    tasks::WorkStealingPool::setScheduling(scheduling);
+    const long long depth = state.range(0);
+    for (auto _ : state) {
+        std::atomic<long long> left{1ll << depth};
+        Promise<bool> done;
+        std::function<void(long long)> spawn = [&spawn, &left, done](long long level) {
+            if (!level) {
+                if (!--left)
+                    done.success(true);
+                return;
+            }
+            tasks::runAndForget([&spawn, level]() { spawn(level - 1); });
+            tasks::runAndForget([&spawn, level]() { spawn(level - 1); });
+        };
+        tasks::runAndForget([&spawn, depth]() { spawn(depth); });
+        done.future().wait();
+    }
+    tasks::WorkStealingPool::setScheduling(tasks::Scheduling::SharedQueue);
+    state.SetItemsProcessed(state.iterations() * (2ll << depth));
+}
+BENCHMARK(bmNestedRunAndForget)->Ranges({{10, 16}, {0, 1}})->UseRealTime();
+
+static void bmClusteredRun(benchmark::State &state)
+{
+    QVector<int> data;
+    for (int i = 0; i < state.range(0); ++i)
+        data << i;
+    for (auto _ : state) {
+        auto result = tasks::clusteredRun(data, [](int x) { return x * 2; }, 256);
+        benchmark::DoNotOptimize(result.resultRef());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmClusteredRun)->Range(1 << 10, 1 << 20)->UseRealTime();
+
+namespace {
+struct HeapTaskState
+{
+    std::function<void()> f;
+    long long payload[4];
+};
+
+struct PooledTaskState : Pooled
+{
+    std::function<void()> f;
+    long long payload[4];
+};
+} // namespace
+
+// Allocation pattern of task queues: objects are allocated in bulk and freed in the same order
+template <typename State>
+static void bmTaskStateAllocation(benchmark::State &state)
+{
+    std::vector<State *> states(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        for (auto &x : states)
+            x = new State();
+        for (auto *x : states)
+            delete x;
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmTaskStateAllocation, HeapTaskState)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(bmTaskStateAllocation, PooledTaskState)->Range(1 << 8, 1 << 16);
+
+// Typical task closure: promise-like handle and a few captured values, too big for std::function local storage
+template <typename Function>
+static void bmTaskClosure(benchmark::State &state)
+{
+    std::vector<Function> queue;
+    queue.reserve(static_cast<size_t>(state.range(0)));
+    auto handle = std::make_shared<long long>(0);
+    for (auto _ : state) {
+        for (long long i = 0; i < state.range(0); ++i)
+            queue.emplace_back([handle, i, from = i * 2, to = i * 3]() { *handle += i + to - from; });
+        for (auto &f : queue)
+            f();
+        queue.clear();
+    }
+    benchmark::DoNotOptimize(*handle);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(bmTaskClosure, std::function<void()>)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(bmTaskClosure, UniqueFunction<void()>)->Range(1 << 8, 1 << 16);
@@ -0,0 +1,251 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_ALGORITHMVIEWS_H
+#define PROOFSEED_ALGORITHMVIEWS_H
+
+#include "proofseed/proofalgorithms.h"
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Proof {
+namespace algorithms {
+// Lazy views. Stages are fused into single pass over source container and only final result is allocated:
+//     auto names = algorithms::from(users) | algorithms::filtered(isActive) | algorithms::mapped(userName)
+//                  | algorithms::to<QSet>();
+// Result is reserved with source size if there are no filtering stages.
+// Lvalue sources are referenced and should outlive the view, rvalue sources are moved into the view.
+// Associative containers are iterated over their values, same as with range-based for.
+namespace detail {
+struct ViewStage
+{};
+
+template <typename Stage>
+constexpr bool IsViewStage_V = std::is_base_of<ViewStage, std::decay_t<Stage>>::value;
+
+template <typename Predicate>
+struct FilteredStage : ViewStage
+{
+    static constexpr bool preservesSize = false;
+    template <typename T>
+    using Output = T;
+
+    template <typename Next>
+    auto wrap(Next next) const
+    {
+        return [this, next](auto &&x) {
+            if (predicate(x))
+                next(std::forward<decltype(x)>(x));
+        };
+    }
+
+    Predicate predicate;
+};
+
+template <typename Func>
+struct MappedStage : ViewStage
+{
+    static constexpr bool preservesSize = true;
+    template <typename T>
+    using Output = std::decay_t<decltype(std::declval<const Func &>()(std::declval<const T &>()))>;
+
+    template <typename Next>
+    auto wrap(Next next) const
+    {
+        return [this, next](auto &&x) { next(func(std::forward<decltype(x)>(x))); };
+    }
+
+    Func func;
+};
+
+template <typename T, typename... Stages>
+struct ViewValue
+{
+    using type = T;
+};
+
+template <typename T, typename Stage, typename... Stages>
+struct ViewValue<T, Stage, Stages...>
+{
+    using type = typename ViewValue<typename Stage::template Output<T>, Stages...>::type;
+};
+
+template <size_t I, typename StagesTuple, typename Sink>
+auto composeStages(const StagesTuple &stages, Sink sink)
+{
+    if constexpr (I == std::tuple_size<StagesTuple>::value)
+        return sink;
+    else
+        return std::get<I>(stages).wrap(composeStages<I + 1>(stages, std::move(sink)));
+}
+
+template <template <typename...> class Container>
+struct ToTerminal
+{};
+
+template <typename Result>
+struct IntoTerminal
+{
+    Result destination;
+};
+
+template <typename Func, typename Acc>
+struct ReducedTerminal
+{
+    Func func;
+    Acc acc;
+};
+} // namespace detail
+
+template <typename Source, typename... Stages>
+class View
+{
+    using SourceContainer = std::decay_t<Source>;
+    using SourceValue = std::decay_t<decltype(*detail::beginIterator(std::declval<const SourceContainer &>()))>;
+
+public:
+    using value_type = typename detail::ViewValue<SourceValue, Stages...>::type;
+    static constexpr bool preservesSize = (true && ... && Stages::preservesSize);
+
+    View(Source source, std::tuple<Stages...> stages)
+        : m_source(std::forward<Source>(source)), m_stages(std::move(stages))
+    {}
+
+    template <typename Result>
+    Result into(Result destination) const
+    {
+        if constexpr (preservesSize)
+            detail::reserveContainer(destination, static_cast<long long>(m_source.size()));
+        forEach([&destination](auto &&x) {
+            asynqro::traverse::detail::containers::add(destination, std::forward<decltype(x)>(x));
+        });
+        return destination;
+    }
+
+    template <template <typename...> class Container>
+    Container<value_type> to() const
+    {
+        return into(Container<value_type>());
+    }
+
+    template <typename Func, typename Acc>
+    Acc reduce(const Func &func, Acc acc) const
+    {
+        forEach([&func, &acc](auto &&x) { acc = func(std::move(acc), std::forward<decltype(x)>(x)); });
+        return acc;
+    }
+
+    template <typename Func>
+    void forEach(const Func &func) const
+    {
+        const auto chain = detail::composeStages<0>(m_stages, [&func](auto &&x) { func(std::forward<decltype(x)>(x)); });
+        auto it = detail::beginIterator(m_source);
+        auto end = detail::endIterator(m_source);
+        for (; it != end; ++it)
+            chain(*it);
+    }
+
+    template <typename Stage, typename = std::enable_if_t<detail::IsViewStage_V<Stage>>>
+    friend View<Source, Stages..., Stage> operator|(View view, Stage stage)
+    {
+        return View<Source, Stages..., Stage>(std::forward<Source>(view.m_source),
+                                              std::tuple_cat(std::move(view.m_stages), std::make_tuple(std::move(stage))));
+    }
+
+    template <template <typename...> class Container>
+    friend Container<value_type> operator|(const View &view, detail::ToTerminal<Container>)
+    {
+        return view.template to<Container>();
+    }
+
+    template <typename Result>
+    friend Result operator|(const View &view, detail::IntoTerminal<Result> terminal)
+    {
+        return view.into(std::move(terminal.destination));
+    }
+
+    template <typename Func, typename Acc>
+    friend Acc operator|(const View &view, detail::ReducedTerminal<Func, Acc> terminal)
+    {
+        return view.reduce(terminal.func, std::move(terminal.acc));
+    }
+
+private:
+    template <typename, typename...>
+    friend class View;
+
+    Source m_source;
+    std::tuple<Stages...> m_stages;
+};
+
+template <typename Container>
+View<const Container &> from(const Container &container)
+{
+    return View<const Container &>(container, std::tuple<>());
+}
+
+template <typename Container, typename = std::enable_if_t<!std::is_lvalue_reference<Container>::value>>
+View<Container> from(Container &&container)
+{
+    return View<Container>(std::move(container), std::tuple<>());
+}
+
+template <typename Predicate>
+detail::FilteredStage<std::decay_t<Predicate>> filtered(Predicate &&predicate)
+{
+    return {{}, std::forward<Predicate>(predicate)};
+}
+
+template <typename Func>
+detail::MappedStage<std::decay_t<Func>> mapped(Func &&func)
+{
+    return {{}, std::forward<Func>(func)};
+}
+
+template <template <typename...> class Container>
+detail::ToTerminal<Container> to()
+{
+    return {};
+}
+
+template <typename Result>
+detail::IntoTerminal<Result> into(Result destination)
+{
+    return {std::move(destination)};
+}
+
+template <typename Func, typename Acc>
+detail::ReducedTerminal<std::decay_t<Func>, Acc> reduced(Func &&func, Acc acc)
+{
+    return {std::forward<Func>(func), std::move(acc)};
+}
+
+} // namespace algorithms
+} // namespace Proof
+
+#endif // PROOFSEED_ALGORITHMVIEWS_H
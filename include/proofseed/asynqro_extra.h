@@ -27,12 +27,25 @@
 #ifndef PROOFSEED_ASYNQRO_EXTRA_H
 #define PROOFSEED_ASYNQRO_EXTRA_H
 
+#include "proofseed/memorypool.h"
+#include "proofseed/tasksmetrics.h"
+#include "proofseed/workstealingpool.h"
+
 #include "asynqro/asynqro"
 
+#include <QSharedPointer>
 #include <QVariant>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
 #include <string>
+#include <tuple>
 #include <type_traits>
+#include <variant>
+#include <vector>
 
 namespace Proof {
 struct Failure
@@ -45,11 +58,14 @@ struct Failure
         DataIsHttpCodeHint = 0x4,
         FromExceptionHint = 0x8
     };
-    Failure(const QString &message, long moduleCode, long errorCode, unsigned long hints = Failure::NoHint,
-            const QVariant &data = QVariant()) noexcept
-        : exists(true), moduleCode(moduleCode), errorCode(errorCode), hints(hints), message(message), data(data)
+    // message and data are implicitly shared, so taking them by value costs only refcount change
+    // and allows to move temporaries in without touching refcounts at all
+    Failure(QString message, long moduleCode, long errorCode, unsigned long hints = Failure::NoHint,
+            QVariant data = QVariant()) noexcept
+        : exists(true), moduleCode(moduleCode), errorCode(errorCode), hints(hints), message(std::move(message)),
+          data(std::move(data))
     {}
-    explicit Failure(const QVariant &data) noexcept : exists(true), data(data) {}
+    explicit Failure(QVariant data) noexcept : exists(true), data(std::move(data)) {}
     Failure() noexcept {}
     Failure(Failure &&) noexcept = default;
     Failure(const Failure &) = default;
@@ -57,9 +73,27 @@ struct Failure
     Failure &operator=(Failure &&) noexcept = default;
     Failure &operator=(const Failure &) = default;
     operator QString() noexcept { return message; } // NOLINT(google-explicit-constructor)
-    Failure withMessage(const QString &msg) const noexcept { return Failure(msg, moduleCode, errorCode, hints, data); }
-    Failure withCode(long module, long error) const noexcept { return Failure(message, module, error, hints, data); }
-    Failure withData(const QVariant &d) const noexcept { return Failure(message, moduleCode, errorCode, hints, d); }
+
+    // lvalue versions make single copy of failure, rvalue versions reuse current one
+    Failure withMessage(QString msg) const &noexcept { return Failure(*this).withMessage(std::move(msg)); }
+    Failure withCode(long module, long error) const &noexcept { return Failure(*this).withCode(module, error); }
+    Failure withData(QVariant d) const &noexcept { return Failure(*this).withData(std::move(d)); }
+    Failure withMessage(QString msg) &&noexcept
+    {
+        message = std::move(msg);
+        return std::move(*this);
+    }
+    Failure withCode(long module, long error) &&noexcept
+    {
+        moduleCode = module;
+        errorCode = error;
+        return std::move(*this);
+    }
+    Failure withData(QVariant d) &&noexcept
+    {
+        data = std::move(d);
+        return std::move(*this);
+    }
 
     bool exists = false;
     long moduleCode = 0;
@@ -68,7 +102,39 @@ struct Failure
     QString message;
     QVariant data;
 };
+} // namespace Proof
+
+namespace asynqro {
+namespace failure {
+template <>
+inline Proof::Failure failureFromString<Proof::Failure>(const std::string &s)
+{
+    QString message = QString::fromStdString(s);
+    unsigned long hints = Proof::Failure::UserFriendlyHint;
+    if (message.startsWith(QLatin1String("Exception", Qt::CaseSensitive)))
+        hints |= Proof::Failure::FromExceptionHint;
+    return Proof::Failure(std::move(message), 0, 0, hints);
+}
+} // namespace failure
+} // namespace asynqro
+
+namespace Proof {
+namespace detail {
+// Should be called only from catch block
+inline Failure failureFromCurrentException() noexcept
+{
+    try {
+        throw;
+    } catch (const std::exception &e) {
+        return asynqro::failure::failureFromString<Failure>(std::string("Exception caught: ") + e.what());
+    } catch (...) {
+        return asynqro::failure::failureFromString<Failure>("Exception caught");
+    }
+}
+} // namespace detail
+} // namespace Proof
 
+namespace Proof {
 template <typename T>
 using Future = asynqro::Future<T, Failure>;
 template <typename T>
@@ -90,6 +156,80 @@ using asynqro::repeater::TrampolinedContinue;
 } // namespace repeater
 
 namespace futures {
+namespace detail {
+template <typename C>
+struct SharedSequenceTraits;
+
+template <template <typename...> typename Container, typename T, typename... Fs>
+struct SharedSequenceTraits<Container<Proof::Future<T>, Fs...>>
+{
+    using Value = T;
+    using Result = Container<T>;
+};
+
+template <typename Container>
+struct SharedSequenceState
+{
+    SharedSequenceState(const QSharedPointer<Container> &container, long long size)
+        : container(container), left(size)
+    {}
+    QSharedPointer<Container> container;
+    std::atomic<long long> left;
+    std::atomic_bool failed{false};
+};
+
+template <typename Container, typename T, typename Func>
+class SharedSequenceRepeater
+{
+public:
+    SharedSequenceRepeater(const QSharedPointer<Container> &data, Func &&f)
+        : m_data(data), m_f(std::move(f)), m_size(static_cast<long long>(data->size()))
+    {}
+
+    static Proof::Future<T> start(const QSharedPointer<SharedSequenceRepeater> &self, T &&initial)
+    {
+        auto result = self->m_promise.future();
+        step(self, 0, std::move(initial));
+        return result;
+    }
+
+private:
+    // Already completed iterations are processed in a loop, callbacks are used only for pending ones
+    static void step(const QSharedPointer<SharedSequenceRepeater> &self, long long index, T &&current)
+    {
+        for (; index < self->m_size; ++index) {
+            Proof::Future<T> next;
+            try {
+                next = self->m_f(*(std::cbegin(*self->m_data) + index), current);
+            } catch (...) {
+                self->m_promise.failure(Proof::detail::failureFromCurrentException());
+                return;
+            }
+            if (!next.isCompleted()) {
+                next.onSuccess([self, index](const T &x) {
+                    T copy = x;
+                    step(self, index + 1, std::move(copy));
+                });
+                next.onFailure([self](const Proof::Failure &failure) { self->m_promise.failure(failure); });
+                return;
+            }
+            if (next.isFailed()) {
+                self->m_promise.failure(next.failureReason());
+                return;
+            }
+            current = next.result();
+        }
+        self->m_promise.success(std::move(current));
+    }
+
+    QSharedPointer<Container> m_data;
+    Func m_f;
+    long long m_size;
+    Proof::Promise<T> m_promise;
+};
+} // namespace detail
+
+// Always creates shared state, futures::ready() from readyfuture.h keeps already known values inline
 template <typename T>
 auto successful(T &&value) noexcept
 {
@@ -132,6 +272,85 @@ auto sequenceWithFailures(Container &&container) noexcept
     return Proof::Future<T>::template sequenceWithFailures<ResultContainer>(std::forward<Container>(container));
 }
 
+// Shared container is kept alive by reference counting, neither container nor futures are copied
+template <typename Container, typename Traits = detail::SharedSequenceTraits<std::remove_const_t<Container>>>
+Proof::Future<typename Traits::Result> sequence(const QSharedPointer<Container> &container) noexcept
+{
+    using T = typename Traits::Value;
+    using Result = typename Traits::Result;
+    const long long size = static_cast<long long>(container->size());
+    if (!size)
+        return Proof::Future<Result>::successful(Result());
+    // Already completed futures are collected in place, without any callbacks
+    if (std::all_of(std::cbegin(*container), std::cend(*container), [](const auto &f) { return f.isCompleted(); })) {
+        Result result;
+        asynqro::traverse::detail::containers::reserve(result, size);
+        for (const auto &f : *container) {
+            if (f.isFailed())
+                return Proof::Future<Result>::failed(f.failureReason());
+            asynqro::traverse::detail::containers::add(result, f.resultRef());
+        }
+        return Proof::Future<Result>::successful(std::move(result));
+    }
+    Proof::Promise<Result> promise;
+    auto state = QSharedPointer<detail::SharedSequenceState<Container>>::create(container, size);
+    for (const auto &future : *container) {
+        future.onSuccess([state, promise, size](const T &) {
+            if (--state->left)
+                return;
+            Result result;
+            asynqro::traverse::detail::containers::reserve(result, size);
+            for (const auto &f : *state->container)
+                asynqro::traverse::detail::containers::add(result, f.resultRef());
+            promise.success(std::move(result));
+        });
+        future.onFailure([state, promise](const Proof::Failure &failure) {
+            if (!state->failed.exchange(true))
+                promise.failure(failure);
+        });
+    }
+    return promise.future();
+}
+
+// Shared container is kept alive by reference counting, neither container nor futures are copied
+template <template <typename...> typename ResultContainer = QHash, typename Container,
+          typename T = typename detail::SharedSequenceTraits<std::remove_const_t<Container>>::Value>
+auto sequenceWithFailures(const QSharedPointer<Container> &container) noexcept
+{
+    using Index = typename std::remove_const_t<Container>::size_type;
+    using Result = std::pair<ResultContainer<Index, T>, ResultContainer<Index, Proof::Failure>>;
+    const long long size = static_cast<long long>(container->size());
+    if (!size)
+        return Proof::Future<Result>::successful(Result());
+    auto collect = [](const Container &futures) {
+        Result result;
+        Index index = 0;
+        for (const auto &f : futures) {
+            if (f.isSucceeded())
+                result.first.insert(index, f.resultRef());
+            else
+                result.second.insert(index, f.failureReason());
+            ++index;
+        }
+        return result;
+    };
+    // Already completed futures are collected in place, without any callbacks
+    if (std::all_of(std::cbegin(*container), std::cend(*container), [](const auto &f) { return f.isCompleted(); }))
+        return Proof::Future<Result>::successful(collect(*container));
+    Proof::Promise<Result> promise;
+    auto state = QSharedPointer<detail::SharedSequenceState<Container>>::create(container, size);
+    auto onCompleted = [state, promise, collect]() {
+        if (--state->left)
+            return;
+        promise.success(collect(*state->container));
+    };
+    for (const auto &future : *container) {
+        future.onSuccess([onCompleted](const T &) { onCompleted(); });
+        future.onFailure([onCompleted](const Proof::Failure &) { onCompleted(); });
+    }
+    return promise.future();
+}
+
 template <typename T, typename Func, typename... Args>
 Proof::Future<T> repeat(Func &&f, Args &&... args) noexcept
 {
@@ -151,6 +370,181 @@ auto repeatForSequence(Container<Data, Ds...> &&data, T &&initial, Func &&f) noe
 {
     return asynqro::repeatForSequence<T>(std::move(data), std::forward<T>(initial), std::forward<Func>(f));
 }
+
+// Shared container is kept alive by reference counting without copying. Container should be random access
+template <typename T, typename Container, typename Func>
+auto repeatForSequence(const QSharedPointer<Container> &data, T &&initial, Func &&f) noexcept
+{
+    using Result = std::decay_t<T>;
+    using Repeater = detail::SharedSequenceRepeater<Container, Result, std::decay_t<Func>>;
+    auto repeater = QSharedPointer<Repeater>::create(data, std::decay_t<Func>(std::forward<Func>(f)));
+    return Repeater::start(repeater, Result(std::forward<T>(initial)));
+}
+
+struct LoopStats
+{
+    long long iterations = 0;
+    // Iterations that returned pending future. Only they add callbacks, all others are run in place
+    long long suspensions = 0;
+    // Since loop start, till result is set if loop is finished
+    std::chrono::steady_clock::duration timeInLoop{};
+    bool finished = false;
+};
+
+namespace detail {
+// Written only by thread that currently runs iterations, handovers are ordered by futures completion
+struct LoopCounters
+{
+    LoopStats stats() const noexcept
+    {
+        LoopStats result;
+        result.iterations = iterations.load(std::memory_order_relaxed);
+        result.suspensions = suspensions.load(std::memory_order_relaxed);
+        const long long finishedAfter = finishedAfterNsecs.load(std::memory_order_acquire);
+        result.finished = finishedAfter >= 0;
+        result.timeInLoop = result.finished ? std::chrono::nanoseconds(finishedAfter)
+                                            : std::chrono::steady_clock::now() - startedAt;
+        return result;
+    }
+
+    void finish() noexcept
+    {
+        finishedAfterNsecs.store(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startedAt).count(),
+            std::memory_order_release);
+    }
+
+    const std::chrono::steady_clock::time_point startedAt = std::chrono::steady_clock::now();
+    std::atomic<long long> iterations{0};
+    std::atomic<long long> suspensions{0};
+    std::atomic<long long> finishedAfterNsecs{-1};
+};
+
+template <typename Returned>
+struct LoopStep
+{
+    using Type = Returned;
+};
+
+template <typename Step>
+struct LoopStep<Proof::Future<Step>>
+{
+    using Type = Step;
+};
+
+// Arguments types are taken from function result, they can differ from ones passed to loop()
+template <typename T, typename Func, typename Step>
+class LoopState;
+
+template <typename T, typename Func, typename... Args>
+class LoopState<T, Func, RepeaterResult<T, Args...>> : public LoopCounters
+{
+public:
+    using Step = RepeaterResult<T, Args...>;
+    using Arguments = std::tuple<Args...>;
+    using Returned = std::decay_t<std::invoke_result_t<Func &, Args...>>;
+
+    LoopState(Func &&f, Arguments &&args) : m_f(std::move(f)), m_args(std::move(args)) {}
+
+    Proof::Future<T> future() const { return m_promise.future(); }
+
+    // Runs iterations until one of them returns pending future, loop is continued from its callback then
+    static void run(const std::shared_ptr<LoopState> &self)
+    {
+        LoopState *state = self.get();
+        try {
+            while (true) {
+                Proof::detail::bumpOwnedCounter(state->iterations);
+                if constexpr (std::is_same_v<Returned, Step>) {
+                    if (!state->apply(std::apply(state->m_f, std::move(state->m_args))))
+                        return;
+                } else {
+                    Proof::Future<Step> next = std::apply(state->m_f, std::move(state->m_args));
+                    if (!next.isCompleted()) {
+                        Proof::detail::bumpOwnedCounter(state->suspensions);
+                        next.onSuccess([self](const Step &x) {
+                            if (self->apply(Step(x)))
+                                run(self);
+                        });
+                        next.onFailure([self](const Proof::Failure &failure) { self->fail(failure); });
+                        return;
+                    }
+                    if (next.isFailed()) {
+                        state->fail(next.failureReason());
+                        return;
+                    }
+                    if (!state->apply(next.result()))
+                        return;
+                }
+            }
+        } catch (...) {
+            state->fail(Proof::detail::failureFromCurrentException());
+        }
+    }
+
+private:
+    // Returns true if loop should go on. Stack doesn't grow between iterations, so TrampolinedContinue is the same
+    // as Continue here
+    bool apply(Step &&step)
+    {
+        if (auto *done = std::get_if<repeater::Finish<T>>(&step)) {
+            finish();
+            m_promise.success(std::move(done->value));
+            return false;
+        }
+        if (auto *next = std::get_if<repeater::Continue<Args...>>(&step))
+            m_args = std::move(next->data);
+        else
+            m_args = std::move(std::get<repeater::TrampolinedContinue<Args...>>(step).data);
+        return true;
+    }
+
+    void fail(const Proof::Failure &failure)
+    {
+        finish();
+        m_promise.failure(failure);
+    }
+
+    Func m_f;
+    Arguments m_args;
+    Proof::Promise<T> m_promise;
+};
+} // namespace detail
+
+template <typename T>
+class Loop
+{
+public:
+    Loop(const std::shared_ptr<const detail::LoopCounters> &counters, const Proof::Future<T> &future)
+        : m_counters(counters), m_future(future)
+    {}
+
+    Proof::Future<T> future() const { return m_future; }
+    operator Proof::Future<T>() const { return m_future; } // NOLINT(google-explicit-constructor)
+
+    // Can be called while loop is running. Loop state (with function and its arguments) is kept while Loop exists
+    LoopStats stats() const noexcept { return m_counters->stats(); }
+
+private:
+    std::shared_ptr<const detail::LoopCounters> m_counters;
+    Proof::Future<T> m_future;
+};
+
+// Same contract as futures::repeat: f(args...) returns either RepeaterResult<T, Args...> or
+// RepeaterFutureResult<T, Args...>. Iterations that return plain or already completed results are run in a loop
+// in place, so they don't allocate anything and don't go through scheduler. Loop state is single pooled allocation,
+// callbacks are added only for iterations that return pending futures and loop goes on in thread that completes them.
+template <typename T, typename Func, typename... Args>
+Loop<T> loop(Func &&f, Args &&... args)
+{
+    using Returned = std::decay_t<std::invoke_result_t<std::decay_t<Func> &, std::decay_t<Args>...>>;
+    using State = detail::LoopState<T, std::decay_t<Func>, typename detail::LoopStep<Returned>::Type>;
+    auto state = makePooledShared<State>(std::decay_t<Func>(std::forward<Func>(f)),
+                                         typename State::Arguments(std::forward<Args>(args)...));
+    Loop<T> result(state, state->future());
+    State::run(state);
+    return result;
+}
 } // namespace futures
 
 namespace tasks {
@@ -166,39 +560,370 @@ struct RunnerInfo
 };
 using Runner = asynqro::tasks::TaskRunner<RunnerInfo>;
 
-template <typename... T>
-auto run(T &&... args)
+namespace detail {
+template <typename T>
+struct IsProofFuture : std::false_type
+{};
+
+template <typename T>
+struct IsProofFuture<Proof::Future<T>> : std::true_type
+{};
+
+// WorkStealingPool has neither priorities nor tags, so only default ones are stolen
+inline bool isStealable(TaskType type = TaskType::Intensive, int32_t tag = 0,
+                        TaskPriority priority = TaskPriority::Regular)
 {
-    return asynqro::tasks::run<Runner>(std::forward<T>(args)...);
+    return type == TaskType::Intensive && !tag && priority == TaskPriority::Regular
+           && WorkStealingPool::scheduling() == Scheduling::WorkStealing;
 }
 
-template <typename... T>
-void runAndForget(T &&... args)
+inline bool isClusterStealable(long long = 1, TaskPriority priority = TaskPriority::Regular)
 {
-    asynqro::tasks::runAndForget<Runner>(std::forward<T>(args)...);
+    return isStealable(TaskType::Intensive, 0, priority);
 }
 
-template <typename... T>
-auto clusteredRun(T &&... args)
+// Result is same type asynqro returns, CancelableFuture is created from promise as it is done in asynqro
+template <typename Result, typename Value>
+Result stolenResult(const Promise<Value> &promise)
 {
-    return asynqro::tasks::clusteredRun<Runner>(std::forward<T>(args)...);
+    if constexpr (std::is_same_v<Result, Future<Value>>)
+        return promise.future();
+    else
+        return Result(promise);
 }
 
-} // namespace tasks
-} // namespace Proof
+// Same results as in asynqro::tasks::run: void tasks are mapped to true and returned futures are flattened
+template <typename Value, typename Task>
+void postStolen(const Promise<Value> &promise, Task &&task)
+{
+    WorkStealingPool::instance()->post([promise, task = std::forward<Task>(task)]() mutable {
+        if (promise.isFilled())
+            return;
+        using Raw = std::decay_t<std::invoke_result_t<std::decay_t<Task> &>>;
+        try {
+            if constexpr (std::is_void_v<Raw>) {
+                task();
+                promise.success(true);
+            } else if constexpr (IsProofFuture<Raw>::value) {
+                task()
+                    .onSuccess([promise](const auto &x) { promise.success(x); })
+                    .onFailure([promise](const Failure &f) { promise.failure(f); });
+            } else {
+                promise.success(task());
+            }
+        } catch (...) {
+            promise.failure(Proof::detail::failureFromCurrentException());
+        }
+    });
+}
 
-namespace asynqro {
-namespace failure {
-template <>
-inline Proof::Failure failureFromString<Proof::Failure>(const std::string &s)
+template <typename Data, typename Func, typename Value, typename = void>
+struct IsStealableCluster : std::false_type
+{};
+
+template <typename Data, typename Func, typename Value>
+struct IsStealableCluster<Data, Func, Value,
+                          std::void_t<decltype(std::declval<const Data &>().size()),
+                                      decltype(std::declval<Value &>().resize(0)),
+                                      std::invoke_result_t<Func &, decltype(std::declval<const Data &>()[0])>>>
+    : std::is_same<typename Value::value_type,
+                   std::decay_t<std::invoke_result_t<Func &, decltype(std::declval<const Data &>()[0])>>>
+{};
+
+// Clusters are filled in place, promise is filled by the last finished cluster
+template <typename Value, typename Data, typename Func>
+void postStolenClusters(const Promise<Value> &promise, Data &&data, Func &&f, long long minClusterSize = 1,
+                        TaskPriority = TaskPriority::Regular)
 {
-    QString message = QString::fromStdString(s);
-    unsigned long hints = Proof::Failure::UserFriendlyHint;
-    if (message.startsWith(QLatin1String("Exception", Qt::CaseSensitive)))
-        hints |= Proof::Failure::FromExceptionHint;
-    return Proof::Failure(message, 0, 0, hints);
+    struct State
+    {
+        State(Data &&data, Func &&f) : data(std::forward<Data>(data)), f(std::forward<Func>(f)) {}
+        std::decay_t<Data> data;
+        std::decay_t<Func> f;
+        Value result;
+        std::atomic<long long> remaining{0};
+        std::atomic_bool failed{false};
+    };
+    auto state = std::make_shared<State>(std::forward<Data>(data), std::forward<Func>(f));
+    const long long size = static_cast<long long>(state->data.size());
+    if (!size) {
+        promise.success(Value());
+        return;
+    }
+    state->result.resize(static_cast<decltype(state->result.size())>(size));
+    const long long capacity = WorkStealingPool::instance()->capacity();
+    const long long clusterSize = qMax(qMax(1ll, minClusterSize), (size + capacity - 1) / capacity);
+    const long long clustersCount = (size + clusterSize - 1) / clusterSize;
+    state->remaining = clustersCount;
+    for (long long cluster = 0; cluster < clustersCount; ++cluster) {
+        WorkStealingPool::instance()->post([promise, state, cluster, clusterSize, size]() {
+            const long long end = qMin(size, (cluster + 1) * clusterSize);
+            try {
+                for (long long i = cluster * clusterSize; i < end; ++i) {
+                    if (state->failed.load(std::memory_order_relaxed))
+                        break;
+                    const auto index = static_cast<decltype(state->data.size())>(i);
+                    state->result[index] = state->f(state->data[index]);
+                }
+            } catch (...) {
+                if (!state->failed.exchange(true))
+                    promise.failure(Proof::detail::failureFromCurrentException());
+            }
+            if (--state->remaining == 0 && !state->failed)
+                promise.success(std::move(state->result));
+        });
+    }
 }
-} // namespace failure
-} // namespace asynqro
+} // namespace detail
+
+// While Scheduling::WorkStealing is selected Intensive tasks with regular priority are posted to WorkStealingPool
+// instead of asynqro Intensive pool. Single tasks are wrapped for TasksMetrics only if metrics are enabled
+template <typename Task, typename... T>
+auto run(Task &&task, T &&... args)
+{
+    if constexpr (std::is_invocable_v<std::decay_t<Task> &>) {
+        if (detail::isStealable(args...)) {
+            using Result = decltype(asynqro::tasks::run<Runner>(std::forward<Task>(task), std::forward<T>(args)...));
+            Promise<typename Result::Value> promise;
+            if (TasksMetrics::isEnabled())
+                detail::postStolen(promise, detail::instrumentTask(std::forward<Task>(task), args...));
+            else
+                detail::postStolen(promise, std::decay_t<Task>(std::forward<Task>(task)));
+            return detail::stolenResult<Result>(promise);
+        }
+        if (TasksMetrics::isEnabled())
+            return asynqro::tasks::run<Runner>(detail::instrumentTask(std::forward<Task>(task), args...),
+                                               std::forward<T>(args)...);
+    }
+    return asynqro::tasks::run<Runner>(std::forward<Task>(task), std::forward<T>(args)...);
+}
+
+namespace detail {
+template <typename Task, typename... T>
+void runAndForget(Task &&task, T &&... args)
+{
+    if (isStealable(args...))
+        WorkStealingPool::instance()->post(UniqueFunction<void()>(std::forward<Task>(task)));
+    else
+        asynqro::tasks::runAndForget<Runner>(std::forward<Task>(task), std::forward<T>(args)...);
+}
+} // namespace detail
+
+template <typename Task, typename... T>
+void runAndForget(Task &&task, T &&... args)
+{
+    if (TasksMetrics::isEnabled())
+        detail::runAndForget(detail::instrumentTask(std::forward<Task>(task), args...), std::forward<T>(args)...);
+    else
+        detail::runAndForget(std::forward<Task>(task), std::forward<T>(args)...);
+}
+
+// Only containers with index access and plain (not future) results are clustered in WorkStealingPool,
+// other overloads always go to asynqro
+template <typename Data, typename Func, typename... T>
+auto clusteredRun(Data &&data, Func &&f, T &&... args)
+{
+    using Result = decltype(asynqro::tasks::clusteredRun<Runner>(std::forward<Data>(data), std::forward<Func>(f),
+                                                                  std::forward<T>(args)...));
+    using Value = typename Result::Value;
+    if constexpr (detail::IsStealableCluster<std::decay_t<Data>, std::decay_t<Func>, Value>::value) {
+        if (detail::isClusterStealable(args...)) {
+            Promise<Value> promise;
+            detail::postStolenClusters(promise, std::forward<Data>(data), std::forward<Func>(f), args...);
+            return detail::stolenResult<Result>(promise);
+        }
+    }
+    return asynqro::tasks::clusteredRun<Runner>(std::forward<Data>(data), std::forward<Func>(f),
+                                                std::forward<T>(args)...);
+}
+
+enum class WindowOrder
+{
+    Ordered,
+    Unordered
+};
+
+namespace detail {
+template <typename Func, typename Input>
+struct WindowedOutput
+{
+    using Raw = std::decay_t<decltype(std::declval<Func &>()(std::declval<const Input &>()))>;
+    template <typename R, bool isFuture = IsProofFuture<R>::value>
+    struct Unwrap
+    {
+        using Type = R;
+    };
+    template <typename R>
+    struct Unwrap<R, true>
+    {
+        using Type = typename R::Value;
+    };
+    using Type = typename Unwrap<Raw>::Type;
+};
+
+template <typename Data, typename Func, typename Result, typename Output>
+class WindowedRunner
+{
+public:
+    WindowedRunner(Data &&data, Func &&f, long long maxInFlight, WindowOrder order, TaskType type, int32_t tag,
+                   TaskPriority priority)
+        : m_data(std::move(data)), m_f(std::move(f)), m_order(order), m_type(type), m_tag(tag), m_priority(priority)
+    {
+        m_size = static_cast<long long>(m_data.size());
+        m_window = qMax(1ll, qMin(maxInFlight, m_size));
+        m_next = std::cbegin(m_data);
+        if (m_order == WindowOrder::Ordered)
+            m_pending.resize(static_cast<size_t>(m_window));
+        asynqro::traverse::detail::containers::reserve(m_results, m_size);
+    }
+
+    static Proof::Future<Result> start(const QSharedPointer<WindowedRunner> &self)
+    {
+        auto result = self->m_promise.future();
+        if (!self->m_size) {
+            self->m_promise.success(Result());
+            return result;
+        }
+        for (long long i = 0; i < self->m_window; ++i)
+            scheduleNext(self);
+        return result;
+    }
+
+private:
+    using Iterator = decltype(std::cbegin(std::declval<const Data &>()));
+
+    // Next element is taken only when previous one is processed, so at most maxInFlight elements are alive at once.
+    // Ordered results wait for all previous ones in ring of maxInFlight slots, so elements are not taken
+    // further than maxInFlight from first not emitted one
+    static void scheduleNext(const QSharedPointer<WindowedRunner> &self)
+    {
+        if (self->m_failed)
+            return;
+        long long index = 0;
+        Iterator it;
+        {
+            SpinLockHolder lock(&self->m_nextLock);
+            if (self->m_scheduled == self->m_size)
+                return;
+            if (self->m_order == WindowOrder::Ordered
+                && self->m_scheduled >= self->m_emitted.load(std::memory_order_acquire) + self->m_window) {
+                return;
+            }
+            index = self->m_scheduled++;
+            it = self->m_next++;
+        }
+        tasks::runAndForget([self, index, it]() { self->process(self, index, *it); }, self->m_type, self->m_tag,
+                            self->m_priority);
+    }
+
+    template <typename Input>
+    void process(const QSharedPointer<WindowedRunner> &self, long long index, const Input &input)
+    {
+        if (m_failed)
+            return;
+        try {
+            if constexpr (IsProofFuture<std::decay_t<decltype(m_f(input))>>::value) {
+                m_f(input)
+                    .onSuccess([self, index](const Output &x) { self->store(self, index, Output(x)); })
+                    .onFailure([self](const Proof::Failure &failure) { self->fail(failure); });
+            } else {
+                store(self, index, m_f(input));
+            }
+        } catch (...) {
+            fail(Proof::detail::failureFromCurrentException());
+        }
+    }
+
+    void store(const QSharedPointer<WindowedRunner> &self, long long index, Output &&value)
+    {
+        if (m_order == WindowOrder::Unordered) {
+            {
+                SpinLockHolder lock(&m_resultsLock);
+                asynqro::traverse::detail::containers::add(m_results, std::move(value));
+            }
+            if (++m_completed == m_size)
+                m_promise.success(std::move(m_results));
+            else
+                scheduleNext(self);
+            return;
+        }
+
+        // Completed prefix is moved to result right away and its slots are reused by next elements
+        long long emitted = 0;
+        bool finished = false;
+        {
+            SpinLockHolder lock(&m_resultsLock);
+            m_pending[static_cast<size_t>(index % m_window)].emplace(std::move(value));
+            long long cursor = m_emitted.load(std::memory_order_relaxed);
+            for (auto *slot = &m_pending[static_cast<size_t>(cursor % m_window)]; *slot;
+                 slot = &m_pending[static_cast<size_t>(cursor % m_window)]) {
+                asynqro::traverse::detail::containers::add(m_results, std::move(**slot));
+                slot->reset();
+                ++emitted;
+                if (++cursor == m_size)
+                    break;
+            }
+            m_emitted.store(cursor, std::memory_order_release);
+            finished = cursor == m_size && emitted;
+        }
+        if (finished) {
+            m_promise.success(std::move(m_results));
+            return;
+        }
+        for (long long i = 0; i < emitted; ++i)
+            scheduleNext(self);
+    }
+
+    void fail(const Proof::Failure &failure)
+    {
+        if (!m_failed.exchange(true))
+            m_promise.failure(failure);
+    }
+
+    const Data m_data;
+    Func m_f;
+    WindowOrder m_order;
+    TaskType m_type;
+    int32_t m_tag;
+    TaskPriority m_priority;
+    long long m_size = 0;
+    long long m_window = 1;
+    Proof::Promise<Result> m_promise;
+
+    SpinLock m_nextLock;
+    Iterator m_next;
+    long long m_scheduled = 0;
+
+    std::atomic<long long> m_completed{0};
+    std::atomic<long long> m_emitted{0};
+    std::atomic_bool m_failed{false};
+    SpinLock m_resultsLock;
+    // Ordered results that wait for previous ones, element with index i is kept in slot i % m_window
+    std::vector<std::optional<Output>> m_pending;
+    Result m_results;
+};
+} // namespace detail
+
+// Streaming alternative to run() over containers: no more than maxInFlight elements are processed at once
+// and next element is taken only when one of previous is done, so memory used for tasks depends on window size
+// and not on container size. Func can return either value or Proof::Future.
+// With WindowOrder::Ordered results are appended to result as soon as all previous ones are ready and
+// elements are never taken more than maxInFlight ahead of first unfinished one, so single slow element
+// stalls the window. With WindowOrder::Unordered results are stored in order of their completion.
+template <template <typename...> typename Container, typename Input, typename... Args, typename Func,
+          typename Output = typename detail::WindowedOutput<std::decay_t<Func>, Input>::Type>
+Proof::Future<Container<Output>> windowedRun(Container<Input, Args...> data, Func &&f, long long maxInFlight,
+                                             WindowOrder order = WindowOrder::Ordered,
+                                             TaskType type = TaskType::Intensive, int32_t tag = 0,
+                                             TaskPriority priority = TaskPriority::Regular)
+{
+    using Runner = detail::WindowedRunner<Container<Input, Args...>, std::decay_t<Func>, Container<Output>, Output>;
+    auto runner = QSharedPointer<Runner>::create(std::move(data), std::decay_t<Func>(std::forward<Func>(f)),
+                                                 maxInFlight, order, type, tag, priority);
+    return Runner::start(runner);
+}
+
+} // namespace tasks
+} // namespace Proof
 
 #endif // PROOFSEED_ASYNQRO_EXTRA_H
@@ -0,0 +1,124 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_BOUNDEDQUEUE_H
+#define PROOFSEED_BOUNDEDQUEUE_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace Proof {
+namespace detail {
+// Bounded multi-producer multi-consumer lock-free queue (Vyukov's algorithm).
+// Real capacity is rounded up to the power of two.
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(long long capacity)
+    {
+        size_t size = 2;
+        while (size < static_cast<size_t>(capacity))
+            size <<= 1;
+        m_mask = size - 1;
+        m_cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue(BoundedQueue &&) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(BoundedQueue &&) = delete;
+    ~BoundedQueue() = default;
+
+    long long capacity() const { return static_cast<long long>(m_mask + 1); }
+
+    // Value is moved only if it was pushed
+    bool push(T &&value)
+    {
+        Cell *cell = nullptr;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (!diff) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data.emplace(std::move(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> pop()
+    {
+        Cell *cell = nullptr;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (!diff) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        std::optional<T> result(std::move(cell->data));
+        cell->data.reset();
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return result;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        std::optional<T> data;
+    };
+
+    // Producers and consumers positions are kept on separate cache lines
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+};
+} // namespace detail
+} // namespace Proof
+
+#endif // PROOFSEED_BOUNDEDQUEUE_H
@@ -0,0 +1,205 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_COROUTINES_H
+#define PROOFSEED_COROUTINES_H
+
+#include "proofseed/asynqro_extra.h"
+#include "proofseed/memorypool.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#    define PROOF_SEED_COROUTINES_SUPPORTED
+#endif
+
+#ifdef PROOF_SEED_COROUTINES_SUPPORTED
+#    include <coroutine>
+#    include <type_traits>
+#    include <utility>
+
+namespace Proof {
+namespace detail {
+// Thrown by co_await on failed future and turned back into the same Failure by coroutine promise.
+// Not derived from std::exception, so it passes through catch (const std::exception &) blocks in coroutine body.
+struct AwaitedFailure
+{
+    Failure failure;
+};
+
+template <typename T, bool discardResult = false>
+class FutureAwaiter
+{
+public:
+    explicit FutureAwaiter(Future<T> future) : m_future(std::move(future)) {}
+    FutureAwaiter(Future<T> future, tasks::TaskType type, int32_t tag)
+        : m_future(std::move(future)), m_rescheduled(true), m_type(type), m_tag(tag)
+    {}
+
+    bool await_ready() const { return !m_rescheduled && m_future.isCompleted(); }
+
+    // Coroutine can be resumed (and this awaiter destroyed) in other thread as soon as first callback is added,
+    // so only local copies are used here
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        Future<T> future = m_future;
+        if (m_rescheduled) {
+            auto resume = [handle, type = m_type, tag = m_tag]() {
+                tasks::runAndForget([handle]() { handle.resume(); }, type, tag);
+            };
+            future.onSuccess([resume](const T &) { resume(); });
+            future.onFailure([resume](const Failure &) { resume(); });
+        } else {
+            future.onSuccess([handle](const T &) { handle.resume(); });
+            future.onFailure([handle](const Failure &) { handle.resume(); });
+        }
+    }
+
+    auto await_resume() const
+    {
+        if (m_future.isFailed())
+            throw AwaitedFailure{m_future.failureReason()};
+        if constexpr (!discardResult)
+            return m_future.result();
+    }
+
+private:
+    Future<T> m_future;
+    bool m_rescheduled = false;
+    tasks::TaskType m_type = tasks::TaskType::Intensive;
+    int32_t m_tag = 0;
+};
+
+class ScheduleAwaiter
+{
+public:
+    ScheduleAwaiter(tasks::TaskType type, int32_t tag) : m_type(type), m_tag(tag) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        tasks::runAndForget([handle]() { handle.resume(); }, m_type, m_tag);
+    }
+    void await_resume() const noexcept {}
+
+private:
+    tasks::TaskType m_type;
+    int32_t m_tag;
+};
+
+template <typename Task, typename Result>
+class TaskPromiseBase
+{
+public:
+    // Whole coroutine frame is single allocation
+    static void *operator new(size_t size) { return MemoryPool::allocate(size); }
+    static void operator delete(void *ptr, size_t size) noexcept { MemoryPool::deallocate(ptr, size); }
+
+    Task get_return_object() const { return Task(m_promise.future()); }
+
+    // Body starts in Intensive task, it can move itself to other pool with co_await tasks::schedule()
+    ScheduleAwaiter initial_suspend() const noexcept { return ScheduleAwaiter(tasks::TaskType::Intensive, 0); }
+    // Result is already passed to future at this point, so frame is destroyed right away
+    std::suspend_never final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() noexcept
+    {
+        try {
+            throw;
+        } catch (const AwaitedFailure &e) {
+            m_promise.failure(e.failure);
+        } catch (...) {
+            m_promise.failure(Proof::detail::failureFromCurrentException());
+        }
+    }
+
+protected:
+    Promise<Result> m_promise;
+};
+
+template <typename Task, typename T>
+class TaskPromise : public TaskPromiseBase<Task, T>
+{
+public:
+    void return_value(const T &value) { this->m_promise.success(value); }
+    void return_value(T &&value) { this->m_promise.success(std::move(value)); }
+};
+
+template <typename Task>
+class TaskPromise<Task, void> : public TaskPromiseBase<Task, bool>
+{
+public:
+    void return_void() { this->m_promise.success(true); }
+};
+} // namespace detail
+
+// Coroutine return type. Coroutine is started in Intensive task right away and its result goes to future(),
+// which also allows to co_await it from other coroutines. Task<void> is resolved with true, as tasks::run does.
+// co_await on Proof::Future in coroutine body resumes it in thread that completed the future (or in current one
+// if it was already completed), failed futures finish coroutine with their failures.
+// Coroutine that is never resumed (e.g. its task was dropped by runner) leaks its frame and never resolves the future.
+template <typename T = void>
+class Task
+{
+public:
+    using Result = std::conditional_t<std::is_void_v<T>, bool, T>;
+    using promise_type = detail::TaskPromise<Task, T>;
+
+    Future<Result> future() const { return m_future; }
+    operator Future<Result>() const { return m_future; } // NOLINT(google-explicit-constructor)
+
+    auto operator co_await() const { return detail::FutureAwaiter<Result, std::is_void_v<T>>(m_future); }
+
+private:
+    friend class detail::TaskPromiseBase<Task, Result>;
+
+    explicit Task(Future<Result> future) : m_future(std::move(future)) {}
+
+    Future<Result> m_future;
+};
+
+template <typename T>
+detail::FutureAwaiter<T> operator co_await(const Future<T> &future)
+{
+    return detail::FutureAwaiter<T>(future);
+}
+
+namespace tasks {
+// co_await tasks::resumeOn(future, type, tag) continues coroutine in task of this type after future is completed
+template <typename T>
+Proof::detail::FutureAwaiter<T> resumeOn(const Future<T> &future, TaskType type, int32_t tag = 0)
+{
+    return Proof::detail::FutureAwaiter<T>(future, type, tag);
+}
+
+// co_await tasks::schedule(type, tag) moves rest of coroutine to task of this type
+inline Proof::detail::ScheduleAwaiter schedule(TaskType type = TaskType::Intensive, int32_t tag = 0)
+{
+    return Proof::detail::ScheduleAwaiter(type, tag);
+}
+} // namespace tasks
+} // namespace Proof
+#endif // PROOF_SEED_COROUTINES_SUPPORTED
+
+#endif // PROOFSEED_COROUTINES_H
@@ -0,0 +1,712 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_FLATHASH_H
+#define PROOFSEED_FLATHASH_H
+
+#include "proofseed/proofalgorithms.h"
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define PROOF_SEED_FLAT_HASH_SSE2
+#endif
+#ifdef _MSC_VER
+#    include <intrin.h>
+#endif
+
+namespace Proof {
+namespace detail {
+namespace flathash {
+// Control byte of each slot is either one of these or 7 bits of element hash (non-negative)
+constexpr qint8 EMPTY = -128;
+constexpr qint8 DELETED = -2;
+constexpr size_t GROUP_WIDTH = 16;
+
+inline int lowestBit(quint32 mask)
+{
+#ifdef _MSC_VER
+    unsigned long result = 0;
+    _BitScanForward(&result, mask);
+    return static_cast<int>(result);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Bit per each control byte of group that matched
+class BitMask
+{
+public:
+    explicit BitMask(quint32 mask) : m_mask(mask) {}
+    explicit operator bool() const { return m_mask != 0; }
+    size_t lowest() const { return static_cast<size_t>(lowestBit(m_mask)); }
+    void removeLowest() { m_mask &= m_mask - 1; }
+
+private:
+    quint32 m_mask;
+};
+
+// Control bytes of GROUP_WIDTH slots compared at once, with SSE2 if it is available
+class Group
+{
+public:
+#ifdef PROOF_SEED_FLAT_HASH_SSE2
+    explicit Group(const qint8 *ctrl) : m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))) {}
+
+    BitMask match(qint8 h2) const { return BitMask(movemask(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl))); }
+    BitMask matchEmpty() const { return BitMask(movemask(_mm_cmpeq_epi8(_mm_set1_epi8(EMPTY), m_ctrl))); }
+    // Both special values are negative, full slots are not
+    BitMask matchFree() const { return BitMask(movemask(m_ctrl)); }
+
+private:
+    static quint32 movemask(__m128i value) { return static_cast<quint32>(_mm_movemask_epi8(value)); }
+
+    __m128i m_ctrl;
+#else
+    explicit Group(const qint8 *ctrl) { std::memcpy(m_ctrl, ctrl, GROUP_WIDTH); }
+
+    BitMask match(qint8 h2) const
+    {
+        return matchIf([h2](qint8 x) { return x == h2; });
+    }
+    BitMask matchEmpty() const
+    {
+        return matchIf([](qint8 x) { return x == EMPTY; });
+    }
+    BitMask matchFree() const
+    {
+        return matchIf([](qint8 x) { return x < 0; });
+    }
+
+private:
+    template <typename Predicate>
+    BitMask matchIf(const Predicate &predicate) const
+    {
+        quint32 result = 0;
+        for (size_t i = 0; i < GROUP_WIDTH; ++i)
+            result |= static_cast<quint32>(predicate(m_ctrl[i])) << i;
+        return BitMask(result);
+    }
+
+    qint8 m_ctrl[GROUP_WIDTH];
+#endif
+};
+
+// Used as control bytes of tables without allocated storage, so lookups don't need special case for them
+inline const qint8 *emptyGroup()
+{
+    alignas(GROUP_WIDTH) static const qint8 group[GROUP_WIDTH] = {EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+                                                                  EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+                                                                  EMPTY, EMPTY, EMPTY, EMPTY};
+    return group;
+}
+
+// Open addressing table with control bytes stored separately from slots.
+// Slots are split into aligned groups of GROUP_WIDTH, element is looked up in the group picked by hash first
+// and then in other groups in triangular sequence. Control bytes of whole group are compared with 7 bits of hash
+// at once and only slots matched this way are compared with key. Lookup stops at the first group with empty slot,
+// so erased slots are marked as deleted unless their group already has empty one.
+// Load factor is kept below 7/8. Elements are moved on rehash, so iterators and references don't survive insertions.
+template <typename Slot, typename Key, typename KeyOf, typename Hasher, typename Equal>
+class Table
+{
+public:
+    static constexpr size_t NOT_FOUND = ~size_t(0);
+
+    Table() = default;
+    Table(const Table &other) : m_hasher(other.m_hasher), m_equal(other.m_equal)
+    {
+        reserve(other.size());
+        for (size_t i = 0; i < other.m_capacity; ++i) {
+            if (other.m_ctrl[i] >= 0)
+                insertUnique(other.m_slots[i]);
+        }
+    }
+    Table(Table &&other) noexcept { swap(other); }
+    Table &operator=(const Table &other)
+    {
+        if (this != &other) {
+            Table copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+    Table &operator=(Table &&other) noexcept
+    {
+        Table moved(std::move(other));
+        swap(moved);
+        return *this;
+    }
+    ~Table() { release(); }
+
+    void swap(Table &other) noexcept
+    {
+        std::swap(m_ctrl, other.m_ctrl);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+        std::swap(m_growthLeft, other.m_growthLeft);
+        std::swap(m_hasher, other.m_hasher);
+        std::swap(m_equal, other.m_equal);
+    }
+
+    long long size() const { return static_cast<long long>(m_size); }
+    long long capacity() const { return static_cast<long long>(m_capacity); }
+    const qint8 *ctrl() const { return m_ctrl; }
+    Slot *slots() const { return m_slots; }
+    const Hasher &hasher() const { return m_hasher; }
+    const Equal &equal() const { return m_equal; }
+
+    void clear()
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (m_ctrl[i] >= 0)
+                m_slots[i].~Slot();
+        }
+        if (m_capacity)
+            std::memset(m_ctrl, EMPTY, m_capacity);
+        m_size = 0;
+        m_growthLeft = maxLoad(m_capacity);
+    }
+
+    void reserve(long long size)
+    {
+        if (size > 0 && static_cast<size_t>(size) > maxLoad(m_capacity))
+            rehash(capacityFor(static_cast<size_t>(size)));
+    }
+
+    void squeeze()
+    {
+        const size_t capacity = m_size ? capacityFor(m_size) : 0;
+        if (capacity < m_capacity)
+            rehash(capacity);
+    }
+
+    size_t find(const Key &key) const { return find(key, hashOf(key)); }
+
+    // Slot is constructed from args only if key is not in the table yet. Key is not used after construction.
+    // Key and args can refer to elements of this table, so if table needs to grow slot is built before rehash.
+    template <typename... Args>
+    std::pair<size_t, bool> tryEmplace(const Key &key, Args &&... args)
+    {
+        const quint64 hash = hashOf(key);
+        const size_t existing = find(key, hash);
+        if (existing != NOT_FOUND)
+            return {existing, false};
+        if (!m_growthLeft) {
+            Slot slot(std::forward<Args>(args)...);
+            grow();
+            return {emplaceAt(findFree(hash), hash, std::move(slot)), true};
+        }
+        return {emplaceAt(findFree(hash), hash, std::forward<Args>(args)...), true};
+    }
+
+    void eraseAt(size_t index)
+    {
+        m_slots[index].~Slot();
+        if (Group(m_ctrl + (index & ~(GROUP_WIDTH - 1))).matchEmpty()) {
+            m_ctrl[index] = EMPTY;
+            ++m_growthLeft;
+        } else {
+            m_ctrl[index] = DELETED;
+        }
+        --m_size;
+    }
+
+    // Index of the next full slot starting from index, capacity if there are no more
+    size_t nextFull(size_t index) const
+    {
+        while (index < m_capacity && m_ctrl[index] < 0)
+            ++index;
+        return index;
+    }
+
+private:
+    static size_t maxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+    static size_t capacityFor(size_t size)
+    {
+        size_t capacity = GROUP_WIDTH;
+        while (maxLoad(capacity) < size)
+            capacity <<= 1;
+        return capacity;
+    }
+
+    // qHash results are often just values itself, so they are mixed before splitting
+    quint64 hashOf(const Key &key) const { return algorithms::detail::mixHash(static_cast<quint64>(m_hasher(key))); }
+    static size_t h1Of(quint64 hash) { return static_cast<size_t>(hash >> 7); }
+    static qint8 h2Of(quint64 hash) { return static_cast<qint8>(hash & 0x7F); }
+
+    size_t groupsCount() const { return m_capacity / GROUP_WIDTH; }
+
+    size_t find(const Key &key, quint64 hash) const
+    {
+        const qint8 h2 = h2Of(hash);
+        const size_t groupsMask = groupsCount() ? groupsCount() - 1 : 0;
+        size_t group = h1Of(hash) & groupsMask;
+        for (size_t step = 1;; ++step) {
+            const Group controls(m_ctrl + group * GROUP_WIDTH);
+            for (BitMask matched = controls.match(h2); matched; matched.removeLowest()) {
+                const size_t index = group * GROUP_WIDTH + matched.lowest();
+                if (m_equal(KeyOf()(m_slots[index]), key))
+                    return index;
+            }
+            if (controls.matchEmpty() || step > groupsMask)
+                return NOT_FOUND;
+            group = (group + step) & groupsMask;
+        }
+    }
+
+    size_t findFree(quint64 hash) const
+    {
+        const size_t groupsMask = groupsCount() - 1;
+        size_t group = h1Of(hash) & groupsMask;
+        for (size_t step = 1;; ++step) {
+            const BitMask free = Group(m_ctrl + group * GROUP_WIDTH).matchFree();
+            if (free)
+                return group * GROUP_WIDTH + free.lowest();
+            group = (group + step) & groupsMask;
+        }
+    }
+
+    template <typename... Args>
+    size_t emplaceAt(size_t index, quint64 hash, Args &&... args)
+    {
+        new (m_slots + index) Slot(std::forward<Args>(args)...);
+        if (m_ctrl[index] == EMPTY)
+            --m_growthLeft;
+        m_ctrl[index] = h2Of(hash);
+        ++m_size;
+        return index;
+    }
+
+    template <typename T>
+    void insertUnique(T &&value)
+    {
+        const quint64 hash = hashOf(KeyOf()(value));
+        emplaceAt(findFree(hash), hash, std::forward<T>(value));
+    }
+
+    // Table with a lot of deleted slots is just cleaned up instead of growing
+    void grow() { rehash(m_size < maxLoad(m_capacity) / 2 ? qMax(m_capacity, GROUP_WIDTH) : capacityFor(m_size + 1)); }
+
+    void rehash(size_t capacity)
+    {
+        Table other;
+        other.m_hasher = m_hasher;
+        other.m_equal = m_equal;
+        if (capacity) {
+            // Slots and control bytes share single allocation, control bytes go after slots to keep slots aligned
+            other.m_slots = static_cast<Slot *>(::operator new(capacity * sizeof(Slot) + capacity));
+            other.m_ctrl = reinterpret_cast<qint8 *>(other.m_slots + capacity);
+            std::memset(other.m_ctrl, EMPTY, capacity);
+            other.m_capacity = capacity;
+            other.m_growthLeft = maxLoad(capacity);
+        }
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (m_ctrl[i] >= 0)
+                other.insertUnique(std::move_if_noexcept(m_slots[i]));
+        }
+        swap(other);
+    }
+
+    void release()
+    {
+        if (!m_capacity)
+            return;
+        clear();
+        ::operator delete(m_slots);
+        m_ctrl = const_cast<qint8 *>(emptyGroup());
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_growthLeft = 0;
+    }
+
+    qint8 *m_ctrl = const_cast<qint8 *>(emptyGroup());
+    Slot *m_slots = nullptr;
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+    size_t m_growthLeft = 0;
+    Hasher m_hasher;
+    Equal m_equal;
+};
+
+struct SetKeyOf
+{
+    template <typename T>
+    const T &operator()(const T &value) const
+    {
+        return value;
+    }
+};
+
+struct MapKeyOf
+{
+    template <typename Pair>
+    const auto &operator()(const Pair &entry) const
+    {
+        return entry.first;
+    }
+};
+
+template <typename TableType, typename Value>
+class SetIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::remove_const_t<Value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value *;
+    using reference = Value &;
+
+    SetIterator() = default;
+    SetIterator(const TableType *table, size_t index) : m_table(table), m_index(table->nextFull(index)) {}
+
+    reference operator*() const { return m_table->slots()[m_index]; }
+    pointer operator->() const { return &m_table->slots()[m_index]; }
+    SetIterator &operator++()
+    {
+        m_index = m_table->nextFull(m_index + 1);
+        return *this;
+    }
+    SetIterator operator++(int)
+    {
+        SetIterator result = *this;
+        ++*this;
+        return result;
+    }
+    bool operator==(const SetIterator &other) const { return m_index == other.m_index; }
+    bool operator!=(const SetIterator &other) const { return m_index != other.m_index; }
+    size_t index() const { return m_index; }
+
+private:
+    const TableType *m_table = nullptr;
+    size_t m_index = 0;
+};
+
+// Same as QHash iterators: operator* gives value, key() and value() are available as well
+template <typename TableType, typename Key, typename Value>
+class MapIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::remove_const_t<Value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value *;
+    using reference = Value &;
+
+    MapIterator() = default;
+    MapIterator(const TableType *table, size_t index) : m_table(table), m_index(table->nextFull(index)) {}
+    template <typename OtherValue, typename = std::enable_if_t<std::is_same<const OtherValue, Value>::value>>
+    MapIterator(const MapIterator<TableType, Key, OtherValue> &other) // NOLINT(google-explicit-constructor)
+        : m_table(other.m_table), m_index(other.m_index)
+    {}
+
+    const Key &key() const { return m_table->slots()[m_index].first; }
+    reference value() const { return m_table->slots()[m_index].second; }
+    reference operator*() const { return value(); }
+    pointer operator->() const { return &value(); }
+    MapIterator &operator++()
+    {
+        m_index = m_table->nextFull(m_index + 1);
+        return *this;
+    }
+    MapIterator operator++(int)
+    {
+        MapIterator result = *this;
+        ++*this;
+        return result;
+    }
+    bool operator==(const MapIterator &other) const { return m_index == other.m_index; }
+    bool operator!=(const MapIterator &other) const { return m_index != other.m_index; }
+    size_t index() const { return m_index; }
+
+private:
+    template <typename, typename, typename>
+    friend class MapIterator;
+
+    const TableType *m_table = nullptr;
+    size_t m_index = 0;
+};
+} // namespace flathash
+} // namespace detail
+
+// Open addressing hash set with SIMD probing (see detail::flathash::Table), drop-in for lookup-heavy QSet usages.
+// Elements are stored inline in one array, so lookups touch one group of control bytes and usually one slot.
+// Interface follows QSet, algorithms (map, filter, toSet with policies, etc.) accept it as source and destination.
+template <typename T, typename Hasher = algorithms::detail::DefaultHasher, typename Equal = std::equal_to<T>>
+class FlatHashSet
+{
+    using Table = detail::flathash::Table<T, T, detail::flathash::SetKeyOf, Hasher, Equal>;
+
+public:
+    using key_type = T;
+    using value_type = T;
+    using hasher = Hasher;
+    using key_equal = Equal;
+    using const_iterator = detail::flathash::SetIterator<Table, const T>;
+    using iterator = const_iterator;
+
+    FlatHashSet() = default;
+    FlatHashSet(std::initializer_list<T> list)
+    {
+        reserve(static_cast<long long>(list.size()));
+        for (const auto &x : list)
+            insert(x);
+    }
+
+    long long size() const { return m_table.size(); }
+    long long count() const { return m_table.size(); }
+    bool isEmpty() const { return !m_table.size(); }
+    bool empty() const { return !m_table.size(); }
+    long long capacity() const { return m_table.capacity(); }
+    void reserve(long long size) { m_table.reserve(size); }
+    void squeeze() { m_table.squeeze(); }
+    void clear() { m_table.clear(); }
+
+    const_iterator begin() const { return const_iterator(&m_table, 0); }
+    const_iterator end() const { return const_iterator(&m_table, static_cast<size_t>(m_table.capacity())); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator constEnd() const { return end(); }
+
+    const_iterator find(const T &value) const { return iteratorAt(m_table.find(value)); }
+    const_iterator constFind(const T &value) const { return find(value); }
+    bool contains(const T &value) const { return m_table.find(value) != Table::NOT_FOUND; }
+
+    // Already present element is kept, same as in QSet
+    const_iterator insert(const T &value) { return const_iterator(&m_table, m_table.tryEmplace(value, value).first); }
+    const_iterator insert(T &&value)
+    {
+        return const_iterator(&m_table, m_table.tryEmplace(value, std::move(value)).first);
+    }
+
+    bool remove(const T &value)
+    {
+        const size_t index = m_table.find(value);
+        if (index == Table::NOT_FOUND)
+            return false;
+        m_table.eraseAt(index);
+        return true;
+    }
+
+    const_iterator erase(const_iterator it)
+    {
+        m_table.eraseAt(it.index());
+        return const_iterator(&m_table, it.index() + 1);
+    }
+
+    bool operator==(const FlatHashSet &other) const
+    {
+        if (size() != other.size())
+            return false;
+        for (const auto &x : *this) {
+            if (!other.contains(x))
+                return false;
+        }
+        return true;
+    }
+    bool operator!=(const FlatHashSet &other) const { return !(*this == other); }
+
+private:
+    const_iterator iteratorAt(size_t index) const
+    {
+        return index == Table::NOT_FOUND ? end() : const_iterator(&m_table, index);
+    }
+
+    Table m_table;
+};
+
+// Open addressing hash map with SIMD probing (see detail::flathash::Table), drop-in for lookup-heavy QHash usages.
+// Keys and values are stored inline next to each other. Interface and iterators follow QHash.
+template <typename Key, typename T, typename Hasher = algorithms::detail::DefaultHasher, typename Equal = std::equal_to<Key>>
+class FlatHashMap
+{
+    using Table = detail::flathash::Table<std::pair<Key, T>, Key, detail::flathash::MapKeyOf, Hasher, Equal>;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = T;
+    using hasher = Hasher;
+    using key_equal = Equal;
+    using iterator = detail::flathash::MapIterator<Table, Key, T>;
+    using const_iterator = detail::flathash::MapIterator<Table, Key, const T>;
+
+    FlatHashMap() = default;
+    FlatHashMap(std::initializer_list<std::pair<Key, T>> list)
+    {
+        reserve(static_cast<long long>(list.size()));
+        for (const auto &x : list)
+            insert(x.first, x.second);
+    }
+
+    long long size() const { return m_table.size(); }
+    long long count() const { return m_table.size(); }
+    bool isEmpty() const { return !m_table.size(); }
+    bool empty() const { return !m_table.size(); }
+    long long capacity() const { return m_table.capacity(); }
+    void reserve(long long size) { m_table.reserve(size); }
+    void squeeze() { m_table.squeeze(); }
+    void clear() { m_table.clear(); }
+
+    iterator begin() { return iterator(&m_table, 0); }
+    iterator end() { return iterator(&m_table, static_cast<size_t>(m_table.capacity())); }
+    const_iterator begin() const { return const_iterator(&m_table, 0); }
+    const_iterator end() const { return const_iterator(&m_table, static_cast<size_t>(m_table.capacity())); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator constEnd() const { return end(); }
+
+    iterator find(const Key &key) { return iteratorAt(m_table.find(key)); }
+    const_iterator find(const Key &key) const { return iteratorAt(m_table.find(key)); }
+    const_iterator constFind(const Key &key) const { return find(key); }
+    bool contains(const Key &key) const { return m_table.find(key) != Table::NOT_FOUND; }
+
+    T value(const Key &key, const T &defaultValue = T()) const
+    {
+        const size_t index = m_table.find(key);
+        return index == Table::NOT_FOUND ? defaultValue : m_table.slots()[index].second;
+    }
+
+    T &operator[](const Key &key)
+    {
+        const size_t index = m_table.tryEmplace(key, key, T()).first;
+        return m_table.slots()[index].second;
+    }
+    const T operator[](const Key &key) const { return value(key); }
+
+    // Value of already present key is replaced, same as in QHash
+    iterator insert(const Key &key, const T &value)
+    {
+        const auto result = m_table.tryEmplace(key, key, value);
+        if (!result.second)
+            m_table.slots()[result.first].second = value;
+        return iterator(&m_table, result.first);
+    }
+
+    // Pairs (std::pair, QPair) are accepted as well, so algorithms can fill it from mapped key/value pairs
+    template <typename Pair>
+    auto insert(const Pair &entry) -> decltype(entry.first, entry.second, iterator())
+    {
+        return insert(entry.first, entry.second);
+    }
+
+    bool remove(const Key &key)
+    {
+        const size_t index = m_table.find(key);
+        if (index == Table::NOT_FOUND)
+            return false;
+        m_table.eraseAt(index);
+        return true;
+    }
+
+    T take(const Key &key)
+    {
+        const size_t index = m_table.find(key);
+        if (index == Table::NOT_FOUND)
+            return T();
+        T result = std::move(m_table.slots()[index].second);
+        m_table.eraseAt(index);
+        return result;
+    }
+
+    iterator erase(const_iterator it)
+    {
+        m_table.eraseAt(it.index());
+        return iterator(&m_table, it.index() + 1);
+    }
+
+    bool operator==(const FlatHashMap &other) const
+    {
+        if (size() != other.size())
+            return false;
+        for (auto it = begin(); it != end(); ++it) {
+            auto otherIt = other.find(it.key());
+            if (otherIt == other.end() || !(*otherIt == *it))
+                return false;
+        }
+        return true;
+    }
+    bool operator!=(const FlatHashMap &other) const { return !(*this == other); }
+
+private:
+    iterator iteratorAt(size_t index) { return index == Table::NOT_FOUND ? end() : iterator(&m_table, index); }
+    const_iterator iteratorAt(size_t index) const
+    {
+        return index == Table::NOT_FOUND ? end() : const_iterator(&m_table, index);
+    }
+
+    Table m_table;
+};
+
+namespace algorithms {
+template <typename Container, typename Input = typename Container::value_type,
+          typename = typename std::enable_if_t<!asynqro::traverse::detail::HasTypeParams_V<Container>>>
+FlatHashSet<Input> toFlatSet(const Container &container)
+{
+    return map(container, identity(), FlatHashSet<Input>());
+}
+
+template <template <typename...> class Container, typename Input>
+FlatHashSet<Input> toFlatSet(const Container<Input> &container)
+{
+    return map(container, identity(), FlatHashSet<Input>());
+}
+
+template <template <typename...> class Container, typename InputKey, typename InputValue, typename... Args>
+FlatHashSet<InputKey> toFlatKeysSet(const Container<InputKey, InputValue, Args...> &container)
+{
+    return map(container, keyIdentity(), FlatHashSet<InputKey>());
+}
+
+// Works with both Qt and std associative containers
+template <template <typename...> class Container, typename InputKey, typename InputValue, typename... Args>
+FlatHashMap<InputKey, InputValue> toFlatMap(const Container<InputKey, InputValue, Args...> &container)
+{
+    FlatHashMap<InputKey, InputValue> result;
+    result.reserve(static_cast<long long>(container.size()));
+    for (auto it = detail::beginIterator(container), end = detail::endIterator(container); it != end; ++it)
+        result.insert(detail::entryKey(it, 0), detail::entryValue(it, 0));
+    return result;
+}
+} // namespace algorithms
+} // namespace Proof
+
+#endif // PROOFSEED_FLATHASH_H
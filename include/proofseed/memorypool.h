@@ -0,0 +1,128 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_MEMORYPOOL_H
+#define PROOFSEED_MEMORYPOOL_H
+
+#include "proofseed/proofseed_global.h"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace Proof {
+struct MemoryPoolStats
+{
+    // Allocations served from thread local free lists
+    quint64 hits = 0;
+    // Allocations that went to shared free lists or carved new slab
+    quint64 misses = 0;
+    // Allocations bigger than MemoryPool::MAX_BLOCK_SIZE, served by global heap
+    quint64 oversized = 0;
+    // Memory taken from global heap for slabs
+    quint64 reservedBytes = 0;
+};
+
+// Fixed size blocks (powers of two from 16 to MAX_BLOCK_SIZE bytes) carved from 64K slabs.
+// Each thread keeps its own free lists and exchanges blocks with shared ones in batches,
+// so most of allocations and deallocations don't take any locks. Blocks can be freed from any thread.
+// Slabs are never returned to global heap: footprint stays at peak usage, but doesn't fragment over time.
+// Only proofseed owned objects use it, Future/Promise shared states are allocated inside asynqro.
+class PROOF_SEED_EXPORT MemoryPool
+{
+public:
+    static constexpr size_t MAX_BLOCK_SIZE = 512;
+
+    MemoryPool() = delete;
+
+    static void *allocate(size_t size);
+    // size should be the same as in allocate() call
+    static void deallocate(void *ptr, size_t size) noexcept;
+    // Counters of different threads are read at slightly different moments
+    static MemoryPoolStats stats() noexcept;
+};
+
+template <typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &) noexcept // NOLINT(google-explicit-constructor)
+    {}
+
+    T *allocate(size_t n)
+    {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        if constexpr (alignof(T) > alignof(std::max_align_t))
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        else
+            return static_cast<T *>(MemoryPool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t n) noexcept
+    {
+        if constexpr (alignof(T) > alignof(std::max_align_t))
+            ::operator delete(ptr, std::align_val_t(alignof(T)));
+        else
+            MemoryPool::deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> &) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> &) const noexcept
+    {
+        return false;
+    }
+};
+
+// Base for types created with new expressions from MemoryPool. Not suitable for over-aligned types.
+// Deletion through pointer to base requires virtual destructor to pass correct size.
+struct Pooled
+{
+    static void *operator new(size_t size) { return MemoryPool::allocate(size); }
+    static void operator delete(void *ptr, size_t size) noexcept { MemoryPool::deallocate(ptr, size); }
+};
+
+// Object and control block share single pooled block
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooledShared(Args &&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+} // namespace Proof
+
+#endif // PROOFSEED_MEMORYPOOL_H
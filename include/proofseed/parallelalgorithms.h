@@ -0,0 +1,1041 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_PARALLELALGORITHMS_H
+#define PROOFSEED_PARALLELALGORITHMS_H
+
+#include "proofseed/asynqro_extra.h"
+#include "proofseed/memorypool.h"
+#include "proofseed/proofalgorithms.h"
+#include "proofseed/vectorizedalgorithms.h"
+
+#include <QSet>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace Proof {
+namespace algorithms {
+struct SequencedPolicy
+{};
+
+struct ParallelPolicy
+{
+    // Amount of elements processed by single task. 0 means it will be calculated from runner capacity
+    long long grainSize = 0;
+    // Containers with less elements than this are processed sequentially in caller thread
+    long long threshold = 1024;
+
+    constexpr ParallelPolicy withGrainSize(long long size) const { return ParallelPolicy{size, threshold}; }
+    constexpr ParallelPolicy withThreshold(long long size) const { return ParallelPolicy{grainSize, size}; }
+};
+
+constexpr SequencedPolicy seq{};
+constexpr ParallelPolicy par{};
+
+namespace detail {
+template <typename C>
+long long containerSize(const C &container)
+{
+    return static_cast<long long>(container.size());
+}
+
+inline long long chunksCount(long long size, const ParallelPolicy &policy)
+{
+    if (size < 2 || size < policy.threshold)
+        return 1;
+    long long grainSize = policy.grainSize;
+    if (grainSize <= 0) {
+        // Few chunks per worker to smooth uneven chunks duration
+        const long long workers = qMax(1, static_cast<int>(tasks::Runner::instance()->capacity()));
+        grainSize = qMax(1ll, size / (workers * 4));
+    }
+    return qMax(1ll, (size + grainSize - 1) / grainSize);
+}
+
+inline long long chunkBegin(long long size, long long chunksCount, long long chunk)
+{
+    return size * chunk / chunksCount;
+}
+
+// Chunks are pulled from shared counter both by helper tasks and by caller thread.
+// Caller never waits for a chunk that is not started yet, so it is safe to use it from Intensive tasks as well.
+class ParallelJob
+{
+public:
+    ParallelJob(long long chunksCount, UniqueFunction<void(long long)> &&work)
+        : m_chunksCount(chunksCount), m_work(std::move(work))
+    {}
+
+    void participate() noexcept
+    {
+        for (long long chunk = m_next++; chunk < m_chunksCount; chunk = m_next++) {
+            if (!m_failed.load(std::memory_order_relaxed)) {
+                try {
+                    m_work(chunk);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!m_failed.exchange(true))
+                        m_exception = std::current_exception();
+                }
+            }
+            if (++m_done == m_chunksCount) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_finished.notify_all();
+            }
+        }
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.wait(lock, [this]() { return m_done.load() == m_chunksCount; });
+        if (m_exception)
+            std::rethrow_exception(m_exception);
+    }
+
+private:
+    const long long m_chunksCount;
+    UniqueFunction<void(long long)> m_work;
+    std::atomic<long long> m_next{0};
+    std::atomic<long long> m_done{0};
+    std::atomic_bool m_failed{false};
+    std::exception_ptr m_exception;
+    std::mutex m_mutex;
+    std::condition_variable m_finished;
+};
+
+// work is called as work(chunkIndex, from, to) for each chunk, possibly concurrently
+template <typename Work>
+void runChunked(long long size, long long chunksCount, const Work &work)
+{
+    if (!size)
+        return;
+    if (chunksCount <= 1) {
+        work(0ll, 0ll, size);
+        return;
+    }
+    auto job = makePooledShared<ParallelJob>(chunksCount, [size, chunksCount, &work](long long chunk) {
+        work(chunk, chunkBegin(size, chunksCount, chunk), chunkBegin(size, chunksCount, chunk + 1));
+    });
+    const long long helpers = qMin(chunksCount - 1, static_cast<long long>(tasks::Runner::instance()->capacity()));
+    for (long long i = 0; i < helpers; ++i)
+        tasks::runAndForget([job]() { job->participate(); }, tasks::TaskType::Intensive);
+    job->participate();
+    job->wait();
+}
+
+// Each chunk keeps its remaining elements at its beginning, keptCounts[chunk] of them.
+// Their prefix sums are destinations of these blocks. Destination of a block can overlap only sources of previous
+// blocks, so blocks are moved in waves: each wave moves in parallel all blocks which destinations don't overlap
+// sources that are not moved yet. Returns new size of container.
+template <typename Iterator>
+long long compactChunks(Iterator begin, long long size, const std::vector<long long> &keptCounts)
+{
+    const long long chunksCount = static_cast<long long>(keptCounts.size());
+    std::vector<long long> sources;
+    std::vector<long long> destinations;
+    std::vector<long long> pending;
+    sources.reserve(keptCounts.size());
+    destinations.reserve(keptCounts.size());
+    long long offset = 0;
+    for (long long chunk = 0; chunk < chunksCount; ++chunk) {
+        const long long kept = keptCounts[static_cast<size_t>(chunk)];
+        sources.push_back(chunkBegin(size, chunksCount, chunk));
+        destinations.push_back(offset);
+        if (kept && offset != sources.back())
+            pending.push_back(chunk);
+        offset += kept;
+    }
+
+    auto moveBlock = [begin, &sources, &destinations, &keptCounts](long long chunk) {
+        const auto index = static_cast<size_t>(chunk);
+        std::move(begin + sources[index], begin + sources[index] + keptCounts[index], begin + destinations[index]);
+    };
+
+    std::vector<long long> ready;
+    std::vector<long long> blocked;
+    while (!pending.empty()) {
+        ready.clear();
+        blocked.clear();
+        // Sources are sorted, so only the last pending block that starts before end of destination can overlap it
+        size_t lastBefore = 0;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            const auto chunk = static_cast<size_t>(pending[i]);
+            const long long destinationEnd = destinations[chunk] + keptCounts[chunk];
+            while (lastBefore < i && sources[static_cast<size_t>(pending[lastBefore])] < destinationEnd)
+                ++lastBefore;
+            bool overlaps = false;
+            if (lastBefore) {
+                const auto previous = static_cast<size_t>(pending[lastBefore - 1]);
+                overlaps = sources[previous] + keptCounts[previous] > destinations[chunk];
+            }
+            (overlaps ? blocked : ready).push_back(pending[i]);
+        }
+        const long long readyCount = static_cast<long long>(ready.size());
+        if (readyCount == 1) {
+            moveBlock(ready.front());
+        } else {
+            runChunked(readyCount, readyCount,
+                       [&ready, &moveBlock](long long, long long from, long long) {
+                           moveBlock(ready[static_cast<size_t>(from)]);
+                       });
+        }
+        pending.swap(blocked);
+    }
+    return offset;
+}
+
+template <typename C, typename = void>
+struct IsResizable : std::false_type
+{};
+
+template <typename C>
+struct IsResizable<C, std::void_t<decltype(std::declval<C &>().resize(1))>>
+    : std::is_default_constructible<typename C::value_type>
+{};
+
+template <typename C>
+constexpr bool IsResizable_V = IsResizable<C>::value;
+
+// Associative containers are rebuilt instead of erasing one by one if more than 1/ERASE_REBUILD_FRACTION of them is erased
+constexpr long long ERASE_REBUILD_FRACTION = 4;
+
+template <typename C, typename K, typename V>
+auto insertEntry(C &container, const K &key, const V &value, int)
+    -> decltype(container.insert(container.cend(), key, value), void())
+{
+    // Entries are added in iteration order, so end is always correct hint for sorted containers
+    container.insert(container.cend(), key, value);
+}
+
+template <typename C, typename K, typename V>
+void insertEntry(C &container, const K &key, const V &value, long)
+{
+    container.insert(key, value);
+}
+
+// Chunks of vectorizable containers are reduced with SIMD kernels, same as whole container in sequential reduce
+template <typename Container, typename Func, typename Acc>
+Acc reduceChunk(const Container &container, long long from, long long to, const Func &func, Acc acc)
+{
+    if constexpr (IsVectorizable_V<Container, Acc> && std::is_same<Func, ops::Plus>::value) {
+        return acc + vectorizedSum(container.data() + from, to - from);
+    } else if constexpr (IsVectorizable_V<Container, Acc> && std::is_same<Func, ops::Min>::value) {
+        return to > from ? func(acc, vectorizedMin(container.data() + from, to - from)) : acc;
+    } else if constexpr (IsVectorizable_V<Container, Acc> && std::is_same<Func, ops::Max>::value) {
+        return to > from ? func(acc, vectorizedMax(container.data() + from, to - from)) : acc;
+    } else {
+        auto begin = beginIterator(container);
+        for (auto it = begin + from, end = begin + to; it != end; ++it)
+            acc = func(std::move(acc), *it);
+        return acc;
+    }
+}
+
+// Adjacent partials are merged pairwise in rounds (0+1, 2+3, ..., then 0+2, 4+6, ...), pairs of each round in parallel.
+// Order of operands is preserved, so combine should only be associative.
+template <typename Acc, typename Combine>
+Acc combineTree(std::vector<Acc> &partials, const Combine &combine)
+{
+    const size_t count = partials.size();
+    for (size_t step = 1; step < count; step *= 2) {
+        const auto pairs = static_cast<long long>((count - step - 1) / (2 * step) + 1);
+        runChunked(pairs, pairs, [&partials, &combine, step](long long, long long from, long long to) {
+            for (long long pair = from; pair < to; ++pair) {
+                const size_t left = static_cast<size_t>(pair) * 2 * step;
+                combine(partials[left], std::move(partials[left + step]));
+            }
+        });
+    }
+    return std::move(partials[0]);
+}
+
+// Upper bounds for sharded map. Amount of intermediate buckets is chunks * shards, so both are limited
+constexpr long long MAX_SHARDS = 64;
+constexpr long long MAX_SHARDED_CHUNKS = 256;
+
+template <typename T, typename = void>
+struct IsHashable : std::is_invocable_r<size_t, std::hash<T>, const T &>
+{};
+
+template <typename T>
+struct IsHashable<T, std::void_t<decltype(qHash(std::declval<const T &>()))>> : std::true_type
+{};
+
+template <typename T, typename = void>
+struct IsEqualityComparable : std::false_type
+{};
+
+template <typename T>
+struct IsEqualityComparable<T, std::void_t<decltype(std::declval<const T &>() == std::declval<const T &>())>>
+    : std::true_type
+{};
+
+template <typename C, typename = void>
+struct IsHashBased : std::false_type
+{};
+
+template <typename C>
+struct IsHashBased<C, std::void_t<typename C::hasher>> : std::true_type
+{};
+
+template <typename T>
+struct IsHashBased<QSet<T>> : std::true_type
+{};
+
+// Sharded map is used only for hash based sets of hashable elements, ordered ones are filled as before
+template <typename Result, typename Output, typename = void>
+struct IsHashedSet : std::false_type
+{};
+
+template <typename Result, typename Output>
+struct IsHashedSet<Result, Output, std::void_t<typename Result::key_type, typename Result::value_type>>
+    : std::integral_constant<bool, std::is_same<typename Result::key_type, Output>::value
+                                       && std::is_same<typename Result::value_type, Output>::value
+                                       && IsHashBased<Result>::value && IsHashable<Output>::value
+                                       && IsEqualityComparable<Output>::value>
+{};
+
+template <typename Result, typename Output>
+constexpr bool IsHashedSet_V = IsHashedSet<Result, Output>::value;
+
+// Non random access containers are indexed once, so their elements can be split into chunks
+template <typename Container>
+auto collectIterators(const Container &container)
+{
+    std::vector<decltype(beginIterator(container))> result;
+    result.reserve(static_cast<size_t>(containerSize(container)));
+    for (auto it = beginIterator(container), end = endIterator(container); it != end; ++it)
+        result.push_back(it);
+    return result;
+}
+
+// Outputs are routed by their hash to shards, so equal elements always meet in the same shard
+// and all shards are deduplicated in parallel without any locking. Only unique elements reach destination,
+// which is reserved for their exact amount, so the only sequential part is one insertion per distinct element.
+// produce(index) is called once for each index in [0, size).
+template <typename Result, typename Produce>
+Result collectSharded(long long size, long long chunksCount, const Produce &produce, Result destination)
+{
+    using Output = typename Result::value_type;
+    const long long shardsCount = qMin(chunksCount, MAX_SHARDS);
+    chunksCount = qMin(chunksCount, MAX_SHARDED_CHUNKS);
+    const DefaultHasher hasher;
+    std::vector<std::vector<Output>> parts(static_cast<size_t>(chunksCount * shardsCount));
+    runChunked(size, chunksCount, [&produce, &parts, &hasher, shardsCount](long long chunk, long long from, long long to) {
+        auto shards = parts.begin() + chunk * shardsCount;
+        for (long long i = from; i < to; ++i) {
+            Output x = produce(i);
+            // Low bits of hash are left for distinct index inside the shard
+            const auto shard = static_cast<long long>((mixHash(static_cast<quint64>(hasher(x))) >> 32) % shardsCount);
+            shards[shard].push_back(std::move(x));
+        }
+    });
+
+    std::vector<std::vector<Output>> shards(static_cast<size_t>(shardsCount));
+    runChunked(shardsCount, shardsCount,
+               [chunksCount, shardsCount, &parts, &shards, &hasher](long long shard, long long, long long) {
+                   auto &result = shards[static_cast<size_t>(shard)];
+                   size_t shardSize = 0;
+                   for (long long chunk = 0; chunk < chunksCount; ++chunk)
+                       shardSize += parts[static_cast<size_t>(chunk * shardsCount + shard)].size();
+                   result.reserve(shardSize);
+                   for (long long chunk = 0; chunk < chunksCount; ++chunk) {
+                       auto &part = parts[static_cast<size_t>(chunk * shardsCount + shard)];
+                       std::move(part.begin(), part.end(), std::back_inserter(result));
+                       std::vector<Output>().swap(part);
+                   }
+                   makeDistinct(result, hasher);
+               });
+
+    long long total = containerSize(destination);
+    for (const auto &shard : shards)
+        total += containerSize(shard);
+    reserveContainer(destination, total);
+    for (auto &shard : shards) {
+        for (auto &x : shard)
+            addToContainer(destination, std::move(x));
+        std::vector<Output>().swap(shard);
+    }
+    return destination;
+}
+} // namespace detail
+
+// All parallel overloads below expect functors to be safe for concurrent calls.
+// Containers without random access iterators are always processed sequentially.
+
+template <typename Container, typename Func>
+auto forEach(const SequencedPolicy &, const Container &container, const Func &func)
+    -> decltype(forEach(container, func))
+{
+    forEach(container, func);
+}
+
+template <typename Container, typename Func>
+auto forEach(const ParallelPolicy &policy, const Container &container, const Func &func)
+    -> decltype(func(*detail::beginIterator(container)), void())
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        auto begin = detail::beginIterator(container);
+        detail::runChunked(size, detail::chunksCount(size, policy), [begin, &func](long long, long long from, long long to) {
+            for (auto it = begin + from, end = begin + to; it != end; ++it)
+                func(*it);
+        });
+    } else {
+        forEach(container, func);
+    }
+}
+
+template <typename Container, typename Func>
+auto forEach(const ParallelPolicy &policy, const Container &container, const Func &func)
+    -> decltype(func(0ll, *detail::beginIterator(container)), void())
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        auto begin = detail::beginIterator(container);
+        detail::runChunked(size, detail::chunksCount(size, policy), [begin, &func](long long, long long from, long long to) {
+            for (long long i = from; i < to; ++i)
+                func(i, *(begin + i));
+        });
+    } else {
+        forEach(container, func);
+    }
+}
+
+template <typename Container, typename Func>
+auto mapInPlace(const SequencedPolicy &, Container &container, const Func &func) -> decltype(mapInPlace(container, func))
+{
+    mapInPlace(container, func);
+}
+
+template <typename Container, typename Func>
+auto mapInPlace(const ParallelPolicy &policy, Container &container, const Func &func)
+    -> decltype(*container.begin() = func(qAsConst(*container.begin())), void())
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        // Non-const begin() is called only once here, so implicitly shared containers are detached before spawning
+        auto begin = container.begin();
+        detail::runChunked(size, detail::chunksCount(size, policy), [begin, &func](long long, long long from, long long to) {
+            for (auto it = begin + from, end = begin + to; it != end; ++it)
+                *it = func(qAsConst(*it));
+        });
+    } else {
+        mapInPlace(container, func);
+    }
+}
+
+template <typename Container, typename Func>
+auto mapInPlace(const ParallelPolicy &policy, Container &container, const Func &func)
+    -> decltype(*container.begin() = func(0ll, qAsConst(*container.begin())), void())
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        auto begin = container.begin();
+        detail::runChunked(size, detail::chunksCount(size, policy), [begin, &func](long long, long long from, long long to) {
+            for (long long i = from; i < to; ++i) {
+                auto it = begin + i;
+                *it = func(i, qAsConst(*it));
+            }
+        });
+    } else {
+        mapInPlace(container, func);
+    }
+}
+
+template <typename Container, typename Func, typename Result>
+auto map(const SequencedPolicy &, const Container &container, const Func &func, Result destination)
+    -> decltype(map(container, func, std::move(destination)))
+{
+    return map(container, func, std::move(destination));
+}
+
+template <typename Container, typename Func, typename Result>
+auto map(const ParallelPolicy &policy, const Container &container, const Func &func, Result destination)
+    -> decltype(detail::addToContainer(destination, func(*detail::beginIterator(container))), Result())
+{
+    using Output = std::decay_t<decltype(func(*detail::beginIterator(container)))>;
+    const long long size = detail::containerSize(container);
+    const long long chunksCount = detail::chunksCount(size, policy);
+    if constexpr (detail::IsRandomAccess_V<Container> && detail::IsHashedSet_V<Result, Output>) {
+        if (chunksCount > 1) {
+            auto begin = detail::beginIterator(container);
+            return detail::collectSharded(size, chunksCount, [begin, &func](long long i) { return func(*(begin + i)); },
+                                          std::move(destination));
+        }
+    } else if constexpr (detail::IsHashedSet_V<Result, Output>) {
+        if (chunksCount > 1) {
+            const auto iterators = detail::collectIterators(container);
+            return detail::collectSharded(size, chunksCount,
+                                          [&iterators, &func](long long i) {
+                                              return func(*iterators[static_cast<size_t>(i)]);
+                                          },
+                                          std::move(destination));
+        }
+    } else if constexpr (detail::IsRandomAccess_V<Container>) {
+        if (chunksCount > 1) {
+            std::vector<std::vector<Output>> parts(static_cast<size_t>(chunksCount));
+            auto begin = detail::beginIterator(container);
+            detail::runChunked(size, chunksCount, [begin, &func, &parts](long long chunk, long long from, long long to) {
+                auto &part = parts[static_cast<size_t>(chunk)];
+                part.reserve(static_cast<size_t>(to - from));
+                for (auto it = begin + from, end = begin + to; it != end; ++it)
+                    part.push_back(func(*it));
+            });
+            detail::reserveContainer(destination, size);
+            for (auto &part : parts) {
+                for (auto &x : part)
+                    detail::addToContainer(destination, std::move(x));
+                std::vector<Output>().swap(part);
+            }
+            return destination;
+        }
+    }
+    return map(container, func, std::move(destination));
+}
+
+template <template <typename...> class Container, typename Input, typename Func, typename... Args,
+          typename Output = std::decay_t<decltype(std::declval<Func>()(std::declval<const Input &>()))>,
+          typename = std::enable_if_t<detail::IsRandomAccess_V<Container<Input, Args...>>>>
+Container<Output> map(const ParallelPolicy &policy, const Container<Input, Args...> &container, const Func &func)
+{
+    return map(policy, container, func, Container<Output>());
+}
+
+// Only hashed destinations of key/value containers are processed in parallel, others fall back to sequential map
+template <typename Container, typename Func, typename Result>
+auto map(const ParallelPolicy &policy, const Container &container, const Func &func, Result destination)
+    -> decltype(detail::addToContainer(destination, func(detail::entryKey(detail::beginIterator(container), 0),
+                                                         detail::entryValue(detail::beginIterator(container), 0))),
+                Result())
+{
+    using Output = std::decay_t<decltype(func(detail::entryKey(detail::beginIterator(container), 0),
+                                              detail::entryValue(detail::beginIterator(container), 0)))>;
+    if constexpr (detail::IsHashedSet_V<Result, Output>) {
+        const long long size = detail::containerSize(container);
+        const long long chunksCount = detail::chunksCount(size, policy);
+        if (chunksCount > 1) {
+            const auto iterators = detail::collectIterators(container);
+            return detail::collectSharded(size, chunksCount,
+                                          [&iterators, &func](long long i) {
+                                              const auto &it = iterators[static_cast<size_t>(i)];
+                                              return func(detail::entryKey(it, 0), detail::entryValue(it, 0));
+                                          },
+                                          std::move(destination));
+        }
+    }
+    return map(container, func, std::move(destination));
+}
+
+template <typename Container>
+auto toSet(const SequencedPolicy &, const Container &container) -> decltype(toSet(container))
+{
+    return toSet(container);
+}
+
+template <typename Container>
+auto toSet(const ParallelPolicy &policy, const Container &container) -> decltype(toSet(container))
+{
+    return map(policy, container, identity(), decltype(toSet(container))());
+}
+
+template <typename Container>
+auto toKeysSet(const SequencedPolicy &, const Container &container) -> decltype(toKeysSet(container))
+{
+    return toKeysSet(container);
+}
+
+template <typename Container>
+auto toKeysSet(const ParallelPolicy &policy, const Container &container) -> decltype(toKeysSet(container))
+{
+    return map(policy, container, keyIdentity(), decltype(toKeysSet(container))());
+}
+
+template <typename Container>
+auto toValuesSet(const SequencedPolicy &, const Container &container) -> decltype(toValuesSet(container))
+{
+    return toValuesSet(container);
+}
+
+template <typename Container>
+auto toValuesSet(const ParallelPolicy &policy, const Container &container) -> decltype(toValuesSet(container))
+{
+    return map(policy, container, valueIdentity(), decltype(toValuesSet(container))());
+}
+
+template <typename Container, typename Predicate>
+auto filter(const SequencedPolicy &, const Container &container, const Predicate &predicate)
+    -> decltype(filter(container, predicate))
+{
+    return filter(container, predicate);
+}
+
+template <typename Container, typename Predicate>
+auto filter(const ParallelPolicy &policy, const Container &container, const Predicate &predicate)
+    -> decltype(predicate(*detail::beginIterator(container)), Container())
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        const long long chunksCount = detail::chunksCount(size, policy);
+        if (chunksCount > 1) {
+            // Only indices are collected in parallel, elements are copied once into final container
+            std::vector<std::vector<long long>> parts(static_cast<size_t>(chunksCount));
+            auto begin = detail::beginIterator(container);
+            detail::runChunked(size, chunksCount, [begin, &predicate, &parts](long long chunk, long long from, long long to) {
+                auto &part = parts[static_cast<size_t>(chunk)];
+                for (long long i = from; i < to; ++i) {
+                    if (predicate(*(begin + i)))
+                        part.push_back(i);
+                }
+            });
+            long long total = 0;
+            for (const auto &part : parts)
+                total += static_cast<long long>(part.size());
+            Container result;
+            detail::reserveContainer(result, total);
+            for (const auto &part : parts) {
+                for (long long i : part)
+                    detail::addToContainer(result, *(begin + i));
+            }
+            return result;
+        }
+    }
+    return filter(container, predicate);
+}
+
+template <typename Container, typename Predicate, typename... Args>
+auto flatFilter(const SequencedPolicy &, const Container &container, const Predicate &predicate, Args &&... args)
+    -> decltype(flatFilter(container, predicate, std::forward<Args>(args)...))
+{
+    return flatFilter(container, predicate, std::forward<Args>(args)...);
+}
+
+// Two passes over random access outer container: matches are marked and counted per inner container in parallel,
+// then their prefix sums give exact positions in destination. Destinations that can be resized
+// (QVector, std::vector of default constructible elements) are filled in parallel, others are filled sequentially
+// from marks with exact reservation. Predicate is called once per element in both cases.
+// Chunks are formed from outer elements and their amount is estimated from total amount of inner elements.
+template <template <typename...> class Container1, template <typename...> class Container2, typename Input,
+          typename Predicate, typename Result>
+auto flatFilter(const ParallelPolicy &policy, const Container1<Container2<Input>> &container, const Predicate &predicate,
+                Result destination)
+    -> decltype(detail::addToContainer(destination, std::declval<const Input &>()),
+                predicate(std::declval<const Input &>()), Result())
+{
+    if constexpr (detail::IsRandomAccess_V<Container1<Container2<Input>>>) {
+        const long long outerSize = detail::containerSize(container);
+        auto begin = detail::beginIterator(container);
+        std::vector<long long> innerOffsets(static_cast<size_t>(outerSize) + 1, 0);
+        for (long long i = 0; i < outerSize; ++i) {
+            innerOffsets[static_cast<size_t>(i) + 1] = innerOffsets[static_cast<size_t>(i)]
+                                                       + detail::containerSize(*(begin + i));
+        }
+        const long long chunksCount = qMin(outerSize, detail::chunksCount(innerOffsets.back(), policy));
+        if (chunksCount > 1) {
+            std::vector<char> marks(static_cast<size_t>(innerOffsets.back()));
+            std::vector<long long> matchOffsets(static_cast<size_t>(outerSize) + 1, 0);
+            detail::runChunked(outerSize, chunksCount,
+                               [begin, &predicate, &innerOffsets, &marks, &matchOffsets](long long, long long from,
+                                                                                         long long to) {
+                                   for (long long i = from; i < to; ++i) {
+                                       char *mark = marks.data() + innerOffsets[static_cast<size_t>(i)];
+                                       long long matched = 0;
+                                       for (const auto &x : *(begin + i)) {
+                                           *mark = predicate(x) ? 1 : 0;
+                                           matched += *mark++;
+                                       }
+                                       matchOffsets[static_cast<size_t>(i) + 1] = matched;
+                                   }
+                               });
+            for (long long i = 0; i < outerSize; ++i)
+                matchOffsets[static_cast<size_t>(i) + 1] += matchOffsets[static_cast<size_t>(i)];
+
+            const long long offset = detail::containerSize(destination);
+            const long long matched = matchOffsets.back();
+            if constexpr (detail::IsResizable_V<Result> && detail::IsRandomAccess_V<Result>) {
+                destination.resize(static_cast<decltype(destination.size())>(offset + matched));
+                // Non-const begin() is called only once here, so implicitly shared containers are detached before spawning
+                auto out = destination.begin() + offset;
+                detail::runChunked(outerSize, chunksCount,
+                                   [begin, out, &innerOffsets, &marks, &matchOffsets](long long, long long from,
+                                                                                      long long to) {
+                                       for (long long i = from; i < to; ++i) {
+                                           const char *mark = marks.data() + innerOffsets[static_cast<size_t>(i)];
+                                           auto it = out + matchOffsets[static_cast<size_t>(i)];
+                                           for (const auto &x : *(begin + i)) {
+                                               if (*mark++)
+                                                   *it++ = x;
+                                           }
+                                       }
+                                   });
+            } else {
+                // Elements are copied straight from source by marks, so it is still the only copy of them
+                detail::reserveContainer(destination, offset + matched);
+                const char *mark = marks.data();
+                for (long long i = 0; i < outerSize; ++i) {
+                    for (const auto &x : *(begin + i)) {
+                        if (*mark++)
+                            detail::addToContainer(destination, x);
+                    }
+                }
+            }
+            return destination;
+        }
+    }
+    return flatFilter(container, predicate, std::move(destination));
+}
+
+template <template <typename...> class Container1, template <typename...> class Container2, typename Input, typename Predicate>
+Container1<Input> flatFilter(const ParallelPolicy &policy, const Container1<Container2<Input>> &container,
+                             const Predicate &predicate)
+{
+    return flatFilter(policy, container, predicate, Container1<Input>());
+}
+
+template <typename Container, typename Predicate>
+auto exists(const SequencedPolicy &, const Container &container, const Predicate &predicate)
+    -> decltype(exists(container, predicate))
+{
+    return exists(container, predicate);
+}
+
+// All parallel chunks stop as soon as any of them finds witness
+template <typename Container, typename Predicate>
+auto exists(const ParallelPolicy &policy, const Container &container, const Predicate &predicate)
+    -> decltype(predicate(*detail::beginIterator(container)), bool())
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        const long long chunksCount = detail::chunksCount(size, policy);
+        if (chunksCount > 1) {
+            std::atomic_bool found{false};
+            auto begin = detail::beginIterator(container);
+            detail::runChunked(size, chunksCount, [begin, &predicate, &found](long long, long long from, long long to) {
+                for (long long i = from; i < to && !found.load(std::memory_order_relaxed); ++i) {
+                    if (predicate(*(begin + i))) {
+                        found = true;
+                        return;
+                    }
+                }
+            });
+            return found;
+        }
+    }
+    return exists(container, predicate);
+}
+
+template <typename Container, typename Predicate>
+auto exists(const ParallelPolicy &, const Container &container, const Predicate &predicate)
+    -> decltype(predicate(detail::beginIterator(container).key(), detail::beginIterator(container).value()), bool())
+{
+    return exists(container, predicate);
+}
+
+template <typename Container, typename Predicate>
+auto forAll(const SequencedPolicy &, const Container &container, const Predicate &predicate)
+    -> decltype(forAll(container, predicate))
+{
+    return forAll(container, predicate);
+}
+
+template <typename Container, typename Predicate>
+auto forAll(const ParallelPolicy &policy, const Container &container, const Predicate &predicate)
+    -> decltype(predicate(*detail::beginIterator(container)), bool())
+{
+    using Value = decltype(*detail::beginIterator(container));
+    return !exists(policy, container, [&predicate](Value x) -> bool { return !predicate(x); });
+}
+
+template <typename Container, typename Predicate>
+auto forAll(const ParallelPolicy &, const Container &container, const Predicate &predicate)
+    -> decltype(predicate(detail::beginIterator(container).key(), detail::beginIterator(container).value()), bool())
+{
+    return forAll(container, predicate);
+}
+
+template <typename Container, typename Predicate, typename T>
+auto findIf(const SequencedPolicy &, const Container &container, const Predicate &predicate, const T &defaultValue)
+    -> decltype(findIf(container, predicate, defaultValue))
+{
+    return findIf(container, predicate, defaultValue);
+}
+
+// Returns first (by position) matching element, same as sequential version.
+// Chunks located after already found element stop immediately, chunks before it continue to look for earlier match.
+template <typename Container, typename Predicate, typename T>
+auto findIf(const ParallelPolicy &policy, const Container &container, const Predicate &predicate, const T &defaultValue)
+    -> decltype(predicate(*detail::beginIterator(container)), T())
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        const long long chunksCount = detail::chunksCount(size, policy);
+        if (chunksCount > 1) {
+            std::atomic<long long> foundIndex{size};
+            auto begin = detail::beginIterator(container);
+            detail::runChunked(size, chunksCount, [begin, &predicate, &foundIndex](long long, long long from, long long to) {
+                for (long long i = from; i < to && i < foundIndex.load(std::memory_order_relaxed); ++i) {
+                    if (predicate(*(begin + i))) {
+                        long long current = foundIndex.load();
+                        while (i < current && !foundIndex.compare_exchange_weak(current, i))
+                            ;
+                        return;
+                    }
+                }
+            });
+            return foundIndex < size ? T(*(begin + foundIndex)) : defaultValue;
+        }
+    }
+    return findIf(container, predicate, defaultValue);
+}
+
+template <typename Container, typename Func, typename Acc, typename... Combine>
+auto reduce(const SequencedPolicy &, const Container &container, const Func &func, Acc acc, const Combine &...)
+    -> decltype(reduce(container, func, std::move(acc)))
+{
+    return reduce(container, func, std::move(acc));
+}
+
+// Each chunk is folded into its own copy of acc, so acc should be identity for combine
+// (0 for sums, empty container for merges, largest value for min). combine(left, right) merges partials
+// of adjacent ranges and should be associative, it is not required to be commutative.
+template <typename Container, typename Func, typename Acc, typename Combine>
+auto reduce(const ParallelPolicy &policy, const Container &container, const Func &func, Acc acc, const Combine &combine)
+    -> decltype(acc = func(std::move(acc), *detail::beginIterator(container)), acc = combine(std::move(acc), std::move(acc)),
+                Acc())
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        const long long chunksCount = detail::chunksCount(size, policy);
+        if (chunksCount > 1) {
+            std::vector<Acc> partials(static_cast<size_t>(chunksCount), acc);
+            detail::runChunked(size, chunksCount, [&container, &func, &partials](long long chunk, long long from, long long to) {
+                Acc &partial = partials[static_cast<size_t>(chunk)];
+                partial = detail::reduceChunk(container, from, to, func, std::move(partial));
+            });
+            return detail::combineTree(partials,
+                                       [&combine](Acc &left, Acc &&right) { left = combine(std::move(left), std::move(right)); });
+        }
+    }
+    return reduce(container, func, std::move(acc));
+}
+
+// Accumulator of the same type as elements, func is used to combine partials as well (e.g. ops::Plus, ops::Min)
+template <typename Container, typename Func, typename Acc,
+          typename = std::enable_if_t<std::is_same<std::decay_t<decltype(*detail::beginIterator(std::declval<const Container &>()))>, Acc>::value>>
+auto reduce(const ParallelPolicy &policy, const Container &container, const Func &func, Acc acc)
+    -> decltype(reduce(policy, container, func, std::move(acc), func))
+{
+    return reduce(policy, container, func, std::move(acc), func);
+}
+
+template <typename Container, typename Func, typename Acc, typename... Combine>
+auto reduceByMutation(const SequencedPolicy &, const Container &container, const Func &func, Acc acc, const Combine &...)
+    -> decltype(reduceByMutation(container, func, std::move(acc)))
+{
+    return reduceByMutation(container, func, std::move(acc));
+}
+
+// In place version of parallel reduce: func(acc, x) modifies partial accumulator of chunk and
+// combine(left, std::move(right)) merges right partial into left one. Same requirements for acc and combine as above.
+template <typename Container, typename Func, typename Acc, typename Combine>
+auto reduceByMutation(const ParallelPolicy &policy, const Container &container, const Func &func, Acc acc,
+                      const Combine &combine)
+    -> decltype(func(acc, *detail::beginIterator(container)), combine(acc, std::move(acc)), Acc())
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        const long long chunksCount = detail::chunksCount(size, policy);
+        if (chunksCount > 1) {
+            std::vector<Acc> partials(static_cast<size_t>(chunksCount), acc);
+            auto begin = detail::beginIterator(container);
+            detail::runChunked(size, chunksCount, [begin, &func, &partials](long long chunk, long long from, long long to) {
+                Acc &partial = partials[static_cast<size_t>(chunk)];
+                for (auto it = begin + from, end = begin + to; it != end; ++it)
+                    func(partial, *it);
+            });
+            return detail::combineTree(partials, combine);
+        }
+    }
+    return reduceByMutation(container, func, std::move(acc));
+}
+
+template <typename Container, typename Func, typename Acc, typename Combine>
+auto reduceByMutation(const ParallelPolicy &, const Container &container, const Func &func, Acc acc, const Combine &)
+    -> decltype(func(acc, detail::beginIterator(container).key(), detail::beginIterator(container).value()), Acc())
+{
+    return reduceByMutation(container, func, std::move(acc));
+}
+
+template <typename Container, typename Predicate>
+auto eraseIf(const SequencedPolicy &, Container &container, const Predicate &predicate)
+    -> decltype(eraseIf(container, predicate))
+{
+    eraseIf(container, predicate);
+}
+
+// Chunks are compacted in parallel, keeping order of remaining elements
+template <typename Container, typename Predicate>
+auto eraseIf(const ParallelPolicy &policy, Container &container, const Predicate &predicate)
+    -> decltype(predicate(qAsConst(*container.begin())), void())
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        const long long chunksCount = detail::chunksCount(size, policy);
+        if (chunksCount > 1) {
+            std::vector<long long> keptCounts(static_cast<size_t>(chunksCount));
+            auto begin = container.begin();
+            detail::runChunked(size, chunksCount, [begin, &predicate, &keptCounts](long long chunk, long long from, long long to) {
+                auto chunkBegin = begin + from;
+                auto chunkEnd = std::remove_if(chunkBegin, begin + to, [&predicate](const auto &x) { return predicate(x); });
+                keptCounts[static_cast<size_t>(chunk)] = static_cast<long long>(chunkEnd - chunkBegin);
+            });
+            const long long newSize = detail::compactChunks(begin, size, keptCounts);
+            container.erase(container.begin() + newSize, container.end());
+            return;
+        }
+    }
+    eraseIf(container, predicate);
+}
+
+// Predicate is called in parallel, container is modified in caller thread
+template <typename Container, typename Predicate>
+auto eraseIf(const ParallelPolicy &policy, Container &container, const Predicate &predicate)
+    -> decltype(predicate(container.begin().key(), qAsConst(container.begin().value())), void())
+{
+    const long long size = detail::containerSize(container);
+    const long long chunksCount = detail::chunksCount(size, policy);
+    if (chunksCount <= 1) {
+        eraseIf(container, predicate);
+        return;
+    }
+    // Detaching before collecting iterators, so they will stay valid till the end
+    container.begin();
+    std::vector<typename Container::const_iterator> entries;
+    entries.reserve(static_cast<size_t>(size));
+    for (auto it = qAsConst(container).begin(), end = qAsConst(container).end(); it != end; ++it)
+        entries.push_back(it);
+
+    std::vector<char> erased(static_cast<size_t>(size), 0);
+    std::atomic<long long> erasedCount{0};
+    detail::runChunked(size, chunksCount,
+                       [&entries, &erased, &erasedCount, &predicate](long long, long long from, long long to) {
+                           long long chunkErased = 0;
+                           for (long long i = from; i < to; ++i) {
+                               const auto &it = entries[static_cast<size_t>(i)];
+                               if (predicate(it.key(), it.value())) {
+                                   erased[static_cast<size_t>(i)] = 1;
+                                   ++chunkErased;
+                               }
+                           }
+                           erasedCount += chunkErased;
+                       });
+    if (!erasedCount)
+        return;
+
+    if (erasedCount * detail::ERASE_REBUILD_FRACTION > size) {
+        Container result;
+        detail::reserveContainer(result, size - erasedCount);
+        for (long long i = 0; i < size; ++i) {
+            if (!erased[static_cast<size_t>(i)])
+                detail::insertEntry(result, entries[static_cast<size_t>(i)].key(), entries[static_cast<size_t>(i)].value(), 0);
+        }
+        entries.clear();
+        container = std::move(result);
+        return;
+    }
+
+    long long i = 0;
+    for (auto it = container.begin(); it != container.end(); ++i) {
+        if (erased[static_cast<size_t>(i)])
+            it = container.erase(it);
+        else
+            ++it;
+    }
+}
+
+template <typename Container>
+void makeUnique(const SequencedPolicy &, Container &container)
+{
+    makeUnique(container);
+}
+
+// Same as sequential version removes only consecutive duplicates, including ones on chunks boundaries
+template <typename Container>
+void makeUnique(const ParallelPolicy &policy, Container &container)
+{
+    if constexpr (detail::IsRandomAccess_V<Container>) {
+        const long long size = detail::containerSize(container);
+        const long long chunksCount = detail::chunksCount(size, policy);
+        if (chunksCount > 1) {
+            using Value = std::decay_t<decltype(*container.begin())>;
+            auto begin = container.begin();
+            // Last elements of chunks are copied before any chunk starts to move its elements
+            std::vector<Value> previousChunkLast;
+            previousChunkLast.reserve(static_cast<size_t>(chunksCount));
+            previousChunkLast.push_back(*begin);
+            for (long long chunk = 1; chunk < chunksCount; ++chunk)
+                previousChunkLast.push_back(*(begin + (detail::chunkBegin(size, chunksCount, chunk) - 1)));
+
+            std::vector<long long> keptCounts(static_cast<size_t>(chunksCount));
+            detail::runChunked(size, chunksCount,
+                               [begin, &previousChunkLast, &keptCounts](long long chunk, long long from, long long to) {
+                                   long long write = from;
+                                   for (long long read = from; read < to; ++read) {
+                                       auto it = begin + read;
+                                       if (write > from) {
+                                           if (*(begin + (write - 1)) == *it)
+                                               continue;
+                                       } else if (chunk && previousChunkLast[static_cast<size_t>(chunk)] == *it) {
+                                           continue;
+                                       }
+                                       if (write != read)
+                                           *(begin + write) = std::move(*it);
+                                       ++write;
+                                   }
+                                   keptCounts[static_cast<size_t>(chunk)] = write - from;
+                               });
+            const long long newSize = detail::compactChunks(begin, size, keptCounts);
+            container.erase(container.begin() + newSize, container.end());
+            return;
+        }
+    }
+    makeUnique(container);
+}
+
+} // namespace algorithms
+} // namespace Proof
+
+#endif // PROOFSEED_PARALLELALGORITHMS_H
@@ -0,0 +1,616 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_PIPELINE_H
+#define PROOFSEED_PIPELINE_H
+
+#include "proofseed/asynqro_extra.h"
+#include "proofseed/boundedqueue.h"
+
+#include <QSharedPointer>
+#include <QVector>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+namespace Proof {
+namespace pipeline {
+struct StageStats
+{
+    long long workers = 0;
+    long long activeWorkers = 0;
+    long long processed = 0;
+    long long queueDepth = 0;
+    long long maxQueueDepth = 0;
+    long long queueCapacity = 0;
+    // How many times stage had something to process but downstream queue was full
+    long long stalls = 0;
+    // Processed elements per second since pipeline start
+    double throughput = 0.0;
+};
+
+namespace detail {
+class PipelineContext;
+
+class StageBase
+{
+public:
+    StageBase(PipelineContext *context, long long workers, tasks::TaskType type)
+        : m_context(context), m_workers(qMax(1ll, workers)), m_type(type)
+    {}
+    StageBase(const StageBase &) = delete;
+    StageBase(StageBase &&) = delete;
+    StageBase &operator=(const StageBase &) = delete;
+    StageBase &operator=(StageBase &&) = delete;
+    virtual ~StageBase() = default;
+
+    // Called by downstream stage when it frees space in its queue
+    void wake()
+    {
+        if (hasWork())
+            trySpawn();
+    }
+
+    virtual void upstreamFinished() {}
+
+    StageStats stats(double elapsedSeconds) const
+    {
+        StageStats result;
+        result.workers = m_workers;
+        result.activeWorkers = m_active.load();
+        result.processed = m_processed.load();
+        result.stalls = m_stalls.load();
+        result.throughput = elapsedSeconds > 0.0 ? static_cast<double>(result.processed) / elapsedSeconds : 0.0;
+        fillQueueStats(result);
+        return result;
+    }
+
+protected:
+    enum class StepResult
+    {
+        Processed,
+        Idle,
+        Blocked,
+        Stopped
+    };
+
+    virtual StepResult step() = 0;
+    virtual bool hasWork() const = 0;
+    virtual bool canProceed() const = 0;
+    // Nothing will be produced by this stage anymore
+    virtual bool isDrained() const = 0;
+    virtual void finish() = 0;
+    virtual void fillQueueStats(StageStats &) const {}
+
+    void trySpawn();
+    void checkFinished()
+    {
+        if (!m_active.load() && isDrained() && !m_finished.exchange(true))
+            finish();
+    }
+
+    template <typename Func>
+    bool guarded(Func &&f);
+
+    PipelineContext *m_context;
+    std::atomic<long long> m_processed{0};
+    std::atomic<long long> m_stalls{0};
+
+private:
+    // Amount of elements processed by single task before it gives its thread back to runner
+    static constexpr int BATCH_SIZE = 64;
+
+    void submit();
+    void work();
+    void leave();
+
+    const long long m_workers;
+    const tasks::TaskType m_type;
+    std::atomic<long long> m_active{0};
+    std::atomic_bool m_finished{false};
+};
+
+class PipelineContext
+{
+public:
+    PipelineContext() = default;
+    PipelineContext(const PipelineContext &) = delete;
+    PipelineContext(PipelineContext &&) = delete;
+    PipelineContext &operator=(const PipelineContext &) = delete;
+    PipelineContext &operator=(PipelineContext &&) = delete;
+    ~PipelineContext() = default;
+
+    static QSharedPointer<PipelineContext> create()
+    {
+        auto result = QSharedPointer<PipelineContext>::create();
+        result->m_self = result.toWeakRef();
+        return result;
+    }
+
+    QSharedPointer<PipelineContext> self() const { return m_self.toStrongRef(); }
+
+    void addStage(const QSharedPointer<StageBase> &stage) { m_stages << stage; }
+
+    bool isFailed() const { return m_failed.load(); }
+
+    Proof::Future<long long> start()
+    {
+        if (!m_started.exchange(true) && !m_stages.isEmpty()) {
+            m_startTime.store(now());
+            m_keepAlive = self();
+            m_stages[0]->wake();
+        }
+        return m_promise.future();
+    }
+
+    void complete(long long consumed)
+    {
+        if (m_done.exchange(true))
+            return;
+        m_endTime.store(now());
+        m_promise.success(consumed);
+        m_keepAlive.reset();
+    }
+
+    void fail(const Proof::Failure &failure)
+    {
+        m_failed = true;
+        if (m_done.exchange(true))
+            return;
+        m_endTime.store(now());
+        m_promise.failure(failure);
+        m_keepAlive.reset();
+    }
+
+    QVector<StageStats> stats() const
+    {
+        const long long start = m_startTime.load();
+        long long end = m_endTime.load();
+        if (!end)
+            end = now();
+        const double elapsed = start ? static_cast<double>(end - start) / 1e9 : 0.0;
+        QVector<StageStats> result;
+        result.reserve(m_stages.size());
+        for (const auto &stage : m_stages)
+            result << stage->stats(elapsed);
+        return result;
+    }
+
+private:
+    static long long now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    QWeakPointer<PipelineContext> m_self;
+    // Running pipeline keeps itself alive until it is done, even if all handles to it are gone
+    QSharedPointer<PipelineContext> m_keepAlive;
+    QVector<QSharedPointer<StageBase>> m_stages;
+    Proof::Promise<long long> m_promise;
+    std::atomic_bool m_started{false};
+    std::atomic_bool m_done{false};
+    std::atomic_bool m_failed{false};
+    std::atomic<long long> m_startTime{0};
+    std::atomic<long long> m_endTime{0};
+};
+
+inline void StageBase::trySpawn()
+{
+    if (m_context->isFailed())
+        return;
+    long long active = m_active.load();
+    while (active < m_workers) {
+        if (m_active.compare_exchange_weak(active, active + 1)) {
+            submit();
+            return;
+        }
+    }
+}
+
+inline void StageBase::submit()
+{
+    auto context = m_context->self();
+    if (!context) {
+        --m_active;
+        return;
+    }
+    tasks::runAndForget([context, this]() { work(); }, m_type);
+}
+
+inline void StageBase::work()
+{
+    for (int i = 0; i < BATCH_SIZE; ++i) {
+        if (m_context->isFailed()) {
+            --m_active;
+            return;
+        }
+        if (step() != StepResult::Processed) {
+            leave();
+            return;
+        }
+    }
+    // Worker slot is kept, task is just moved back to the runner queue to let others run
+    submit();
+}
+
+// Worker never waits for downstream or for input. It leaves instead and either upstream (on new element)
+// or downstream (on freed space) spawns it again. Condition is rechecked after leaving to not miss a wakeup
+// that happened while this worker was still counted as active.
+inline void StageBase::leave()
+{
+    --m_active;
+    if (m_context->isFailed())
+        return;
+    if (hasWork() && canProceed())
+        trySpawn();
+    checkFinished();
+}
+
+template <typename Func>
+bool StageBase::guarded(Func &&f)
+{
+    try {
+        f();
+        return true;
+    } catch (...) {
+        m_context->fail(Proof::detail::failureFromCurrentException());
+    }
+    return false;
+}
+
+// Stage with input queue. Every element in queue or about to be pushed to it holds a slot, so upstream
+// reserves slot before taking next element and it is guaranteed to fit
+template <typename T>
+class Inlet : public StageBase
+{
+public:
+    Inlet(PipelineContext *context, long long workers, tasks::TaskType type, long long capacity)
+        : StageBase(context, workers, type), m_capacity(qMax(1ll, capacity)), m_queue(m_capacity)
+    {}
+
+    void setUpstream(StageBase *upstream) { m_upstream = upstream; }
+
+    bool tryReserve()
+    {
+        long long occupied = m_occupied.load();
+        while (occupied < m_capacity) {
+            if (m_occupied.compare_exchange_weak(occupied, occupied + 1))
+                return true;
+        }
+        return false;
+    }
+
+    void cancelReservation() { --m_occupied; }
+
+    bool hasRoom() const { return m_occupied.load() < m_capacity; }
+
+    void push(T &&value)
+    {
+        // Slot is reserved, but cell can still be in process of being read by consumer that started earlier
+        while (!m_queue.push(std::move(value)))
+            std::this_thread::yield();
+        const long long depth = ++m_queued;
+        long long maxDepth = m_maxQueued.load(std::memory_order_relaxed);
+        while (depth > maxDepth && !m_maxQueued.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed)) {
+        }
+        trySpawn();
+    }
+
+    void upstreamFinished() override
+    {
+        m_upstreamFinished = true;
+        checkFinished();
+    }
+
+protected:
+    std::optional<T> pop()
+    {
+        std::optional<T> result = m_queue.pop();
+        if (result) {
+            --m_queued;
+            --m_occupied;
+            if (m_upstream)
+                m_upstream->wake();
+        }
+        return result;
+    }
+
+    bool hasWork() const override { return m_queued.load() > 0; }
+    bool isDrained() const override { return m_upstreamFinished.load() && m_queued.load() <= 0; }
+    void fillQueueStats(StageStats &stats) const override
+    {
+        stats.queueDepth = qMax(0ll, m_queued.load());
+        stats.maxQueueDepth = m_maxQueued.load();
+        stats.queueCapacity = m_capacity;
+    }
+
+private:
+    const long long m_capacity;
+    Proof::detail::BoundedQueue<T> m_queue;
+    StageBase *m_upstream = nullptr;
+    std::atomic<long long> m_occupied{0};
+    std::atomic<long long> m_queued{0};
+    std::atomic<long long> m_maxQueued{0};
+    std::atomic_bool m_upstreamFinished{false};
+};
+
+template <typename T>
+class Outlet
+{
+public:
+    void setDownstream(Inlet<T> *downstream) { m_downstream = downstream; }
+
+protected:
+    Inlet<T> *m_downstream = nullptr;
+};
+
+template <typename T, typename Generator>
+class SourceStage : public StageBase, public Outlet<T>
+{
+public:
+    // Generator is never called concurrently, so source always has single worker
+    SourceStage(PipelineContext *context, Generator &&generator, tasks::TaskType type)
+        : StageBase(context, 1, type), m_generator(std::move(generator))
+    {}
+
+protected:
+    StepResult step() override
+    {
+        if (m_exhausted)
+            return StepResult::Idle;
+        if (!this->m_downstream->tryReserve()) {
+            ++m_stalls;
+            return StepResult::Blocked;
+        }
+        std::optional<T> value;
+        if (!guarded([this, &value]() { value = m_generator(); })) {
+            this->m_downstream->cancelReservation();
+            return StepResult::Stopped;
+        }
+        if (!value) {
+            this->m_downstream->cancelReservation();
+            m_exhausted = true;
+            return StepResult::Idle;
+        }
+        ++m_processed;
+        this->m_downstream->push(std::move(*value));
+        return StepResult::Processed;
+    }
+
+    bool hasWork() const override { return !m_exhausted.load(); }
+    bool canProceed() const override { return this->m_downstream->hasRoom(); }
+    bool isDrained() const override { return m_exhausted.load(); }
+    void finish() override { this->m_downstream->upstreamFinished(); }
+
+private:
+    Generator m_generator;
+    std::atomic_bool m_exhausted{false};
+};
+
+template <typename In, typename Out, typename Func>
+class TransformStage : public Inlet<In>, public Outlet<Out>
+{
+    using StepResult = typename Inlet<In>::StepResult;
+
+public:
+    TransformStage(PipelineContext *context, Func &&f, long long workers, tasks::TaskType type, long long capacity)
+        : Inlet<In>(context, workers, type, capacity), m_f(std::move(f))
+    {}
+
+protected:
+    StepResult step() override
+    {
+        if (!this->m_downstream->tryReserve()) {
+            if (this->hasWork())
+                ++this->m_stalls;
+            return StepResult::Blocked;
+        }
+        std::optional<In> input = this->pop();
+        if (!input) {
+            this->m_downstream->cancelReservation();
+            return StepResult::Idle;
+        }
+        std::optional<Out> output;
+        if (!this->guarded([this, &input, &output]() { output.emplace(m_f(std::move(*input))); })) {
+            this->m_downstream->cancelReservation();
+            return StepResult::Stopped;
+        }
+        ++this->m_processed;
+        this->m_downstream->push(std::move(*output));
+        return StepResult::Processed;
+    }
+
+    bool canProceed() const override { return this->m_downstream->hasRoom(); }
+    void finish() override { this->m_downstream->upstreamFinished(); }
+
+private:
+    Func m_f;
+};
+
+template <typename In, typename Func>
+class SinkStage : public Inlet<In>
+{
+    using StepResult = typename Inlet<In>::StepResult;
+
+public:
+    SinkStage(PipelineContext *context, Func &&f, long long workers, tasks::TaskType type, long long capacity)
+        : Inlet<In>(context, workers, type, capacity), m_f(std::move(f))
+    {}
+
+protected:
+    StepResult step() override
+    {
+        std::optional<In> input = this->pop();
+        if (!input)
+            return StepResult::Idle;
+        if (!this->guarded([this, &input]() { m_f(std::move(*input)); }))
+            return StepResult::Stopped;
+        ++this->m_processed;
+        return StepResult::Processed;
+    }
+
+    bool canProceed() const override { return true; }
+    void finish() override { this->m_context->complete(this->m_processed.load()); }
+
+private:
+    Func m_f;
+};
+
+template <typename Container>
+class ContainerGenerator
+{
+    using Iterator = decltype(std::begin(std::declval<Container &>()));
+
+public:
+    using Value = std::decay_t<decltype(*std::declval<Iterator>())>;
+
+    explicit ContainerGenerator(Container &&data) : m_data(std::move(data)) {}
+
+    std::optional<Value> operator()()
+    {
+        // Iterator is created lazily, when generator is already at its final place
+        if (!m_it)
+            m_it = std::begin(m_data);
+        if (*m_it == std::end(m_data))
+            return std::nullopt;
+        return std::move(*(*m_it)++);
+    }
+
+private:
+    Container m_data;
+    std::optional<Iterator> m_it;
+};
+
+template <typename T>
+struct GeneratedValue
+{};
+
+template <typename T>
+struct GeneratedValue<std::optional<T>>
+{
+    using Type = T;
+};
+} // namespace detail
+
+class Pipeline
+{
+public:
+    // Starts pipeline. Result is amount of elements consumed by sink.
+    // Only first call starts it, all subsequent calls return the same future.
+    Proof::Future<long long> run() { return m_context->start(); }
+
+    // Per stage statistics, source is the first one and sink is the last one
+    QVector<StageStats> stats() const { return m_context->stats(); }
+
+private:
+    template <typename>
+    friend class PipelineBuilder;
+    explicit Pipeline(const QSharedPointer<detail::PipelineContext> &context) : m_context(context) {}
+
+    QSharedPointer<detail::PipelineContext> m_context;
+};
+
+// Each stage has its own bounded input queue and its own amount of workers. Workers are regular runner tasks
+// and they never block: if downstream queue is full worker just leaves and stage is resumed when downstream
+// frees some space. Because of that pipeline is safe to use with any amount of stages regardless of runner capacity.
+// Stage functors can be called concurrently if stage has more than one worker.
+// Elements order is preserved only if all stages have single worker.
+template <typename T>
+class PipelineBuilder
+{
+public:
+    template <typename Func, typename Out = std::decay_t<std::invoke_result_t<std::decay_t<Func> &, T &&>>>
+    PipelineBuilder<Out> stage(Func &&f, long long workers = 1, tasks::TaskType type = tasks::TaskType::Intensive,
+                               long long queueCapacity = 128) &&
+    {
+        static_assert(!std::is_void_v<Out>, "Use sink() for functors without result");
+        using Stage = detail::TransformStage<T, Out, std::decay_t<Func>>;
+        auto stage = QSharedPointer<Stage>::create(m_context.data(), std::decay_t<Func>(std::forward<Func>(f)), workers,
+                                                   type, queueCapacity);
+        attach(stage.data());
+        m_context->addStage(stage);
+        return PipelineBuilder<Out>(m_context, stage.data(), stage.data());
+    }
+
+    template <typename Func>
+    Pipeline sink(Func &&f, long long workers = 1, tasks::TaskType type = tasks::TaskType::Intensive,
+                  long long queueCapacity = 128) &&
+    {
+        using Stage = detail::SinkStage<T, std::decay_t<Func>>;
+        auto stage = QSharedPointer<Stage>::create(m_context.data(), std::decay_t<Func>(std::forward<Func>(f)), workers,
+                                                   type, queueCapacity);
+        attach(stage.data());
+        m_context->addStage(stage);
+        return Pipeline(m_context);
+    }
+
+    // Use from() instead of direct construction
+    PipelineBuilder(const QSharedPointer<detail::PipelineContext> &context, detail::StageBase *last,
+                    detail::Outlet<T> *outlet)
+        : m_context(context), m_last(last), m_outlet(outlet)
+    {}
+
+private:
+    void attach(detail::Inlet<T> *inlet)
+    {
+        m_outlet->setDownstream(inlet);
+        inlet->setUpstream(m_last);
+    }
+
+    QSharedPointer<detail::PipelineContext> m_context;
+    detail::StageBase *m_last;
+    detail::Outlet<T> *m_outlet;
+};
+
+// Generator is called sequentially and should return std::nullopt when there are no more elements
+template <typename Generator,
+          typename = std::enable_if_t<std::is_invocable_v<std::decay_t<Generator> &>>>
+auto from(Generator &&generator, tasks::TaskType type = tasks::TaskType::Intensive)
+{
+    using T = typename detail::GeneratedValue<std::decay_t<std::invoke_result_t<std::decay_t<Generator> &>>>::Type;
+    using Source = detail::SourceStage<T, std::decay_t<Generator>>;
+    auto context = detail::PipelineContext::create();
+    auto source = QSharedPointer<Source>::create(context.data(), std::decay_t<Generator>(std::forward<Generator>(generator)),
+                                                 type);
+    context->addStage(source);
+    return PipelineBuilder<T>(context, source.data(), source.data());
+}
+
+template <template <typename...> typename Container, typename T, typename... Args,
+          typename = std::enable_if_t<!std::is_invocable_v<Container<T, Args...> &>>>
+auto from(Container<T, Args...> data, tasks::TaskType type = tasks::TaskType::Intensive)
+{
+    return from(detail::ContainerGenerator<Container<T, Args...>>(std::move(data)), type);
+}
+} // namespace pipeline
+} // namespace Proof
+
+#endif // PROOFSEED_PIPELINE_H
@@ -27,18 +27,26 @@
 #ifndef PROOFSEED_PLANTING_H
 #define PROOFSEED_PLANTING_H
 
+#include "proofseed/algorithmviews.h"
 #include "proofseed/asynqro_extra.h"
+#include "proofseed/flathash.h"
+#include "proofseed/parallelalgorithms.h"
+#include "proofseed/pipeline.h"
 #include "proofseed/proofalgorithms.h"
+#include "proofseed/readyfuture.h"
 #include "proofseed/tasks.h"
+#include "proofseed/vectorizedalgorithms.h"
 
 namespace algorithms = Proof::algorithms;
 namespace tasks = Proof::tasks;
 namespace futures = Proof::futures;
+namespace pipeline = Proof::pipeline;
 
 using Proof::CancelableFuture;
 using Proof::Failure;
 using Proof::Future;
 using Proof::Promise;
+using Proof::ReadyFuture;
 using Proof::RepeaterFutureResult;
 using Proof::RepeaterResult;
 using Proof::SpinLock;
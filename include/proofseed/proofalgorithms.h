@@ -32,16 +32,20 @@
 #include <QPair>
 
 #include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 namespace Proof {
 namespace algorithms {
 namespace detail {
 template <typename C, typename T>
-void addToContainer(C &container, const T &value)
+void addToContainer(C &container, T &&value)
 {
-    asynqro::traverse::detail::containers::add(container, value);
+    asynqro::traverse::detail::containers::add(container, std::forward<T>(value));
 }
 
 template <typename C>
@@ -62,6 +66,258 @@ auto endIterator(C &container)
     return asynqro::traverse::detail::containers::end(container);
 }
 
+template <typename C, typename = void>
+struct IsRandomAccess : std::false_type
+{};
+
+template <typename C>
+struct IsRandomAccess<C, std::enable_if_t<std::is_base_of<
+                             std::random_access_iterator_tag,
+                             typename std::iterator_traits<decltype(std::declval<C &>().begin())>::iterator_category>::value>>
+    : std::true_type
+{};
+
+template <typename C>
+constexpr bool IsRandomAccess_V = IsRandomAccess<std::decay_t<C>>::value;
+
+struct DefaultHasher
+{
+    template <typename T>
+    size_t operator()(const T &value) const
+    {
+        return hash(value, 0);
+    }
+
+private:
+    template <typename T>
+    static auto hash(const T &value, int) -> decltype(static_cast<size_t>(qHash(value)))
+    {
+        return static_cast<size_t>(qHash(value));
+    }
+
+    template <typename T>
+    static size_t hash(const T &value, long)
+    {
+        return std::hash<T>()(value);
+    }
+};
+
+// qHash results are 32 bit and often are just values itself, so they are mixed before masking
+inline quint64 mixHash(quint64 hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Open addressing set of indices of elements stored elsewhere. Slot contains index + 1, zero means empty slot.
+// Table is sized once from elements count and keeps load factor below 1/2.
+template <typename Index, typename Iterator, typename Hasher>
+class DistinctIndex
+{
+public:
+    DistinctIndex(Iterator elements, long long size, const Hasher &hasher) : m_elements(elements), m_hasher(hasher)
+    {
+        size_t capacity = 16;
+        while (capacity < static_cast<size_t>(size) * 2)
+            capacity <<= 1;
+        m_mask = capacity - 1;
+        m_slots.resize(capacity, 0);
+    }
+
+    // Returns false if equal element is already indexed, otherwise remembers that value is stored at index
+    template <typename T>
+    bool insert(const T &value, long long index)
+    {
+        size_t slot = static_cast<size_t>(mixHash(static_cast<quint64>(m_hasher(value)))) & m_mask;
+        for (; m_slots[slot]; slot = (slot + 1) & m_mask) {
+            if (*(m_elements + static_cast<long long>(m_slots[slot] - 1)) == value)
+                return false;
+        }
+        m_slots[slot] = static_cast<Index>(index + 1);
+        return true;
+    }
+
+private:
+    Iterator m_elements;
+    Hasher m_hasher;
+    size_t m_mask = 0;
+    std::vector<Index> m_slots;
+};
+
+template <typename Iterator, typename Hasher, typename Func>
+auto withDistinctIndex(Iterator elements, long long size, const Hasher &hasher, const Func &func)
+{
+    if (size < static_cast<long long>(std::numeric_limits<quint32>::max())) {
+        DistinctIndex<quint32, Iterator, Hasher> index(elements, size, hasher);
+        return func(index);
+    }
+    DistinctIndex<quint64, Iterator, Hasher> index(elements, size, hasher);
+    return func(index);
+}
+
+// Rvalue Qt container still can share its data with other copies.
+// Moving elements out of it would detach (deep copy) it first, so such containers are copied from instead.
+// Copying branches are compiled only for implicitly shared containers, std ones can hold move-only types.
+template <typename C, typename = void>
+struct IsImplicitlyShared : std::false_type
+{};
+
+template <typename C>
+struct IsImplicitlyShared<C, std::void_t<decltype(std::declval<const C &>().isDetached())>> : std::true_type
+{};
+
+template <typename C, typename = void>
+struct HasNodeExtract : std::false_type
+{};
+
+template <typename C>
+struct HasNodeExtract<C, std::void_t<decltype(std::declval<C &>().extract(std::declval<C &>().begin()).key())>>
+    : std::true_type
+{};
+
+template <typename C>
+auto shrinkContainer(C &container, int) -> decltype(container.squeeze(), void())
+{
+    container.squeeze();
+}
+
+template <typename C>
+auto shrinkContainer(C &container, long) -> decltype(container.shrink_to_fit(), void())
+{
+    container.shrink_to_fit();
+}
+
+template <typename C>
+void shrinkContainer(C &, ...)
+{}
+
+// Upper bound of flattened size (exact if nothing is filtered out). Only sizes of inner containers are summed,
+// their elements are not visited, so it is O(outer) for containers with O(1) size()
+template <typename C>
+long long flattenedSize(const C &container)
+{
+    long long result = 0;
+    for (const auto &inner : container)
+        result += static_cast<long long>(inner.size());
+    return result;
+}
+
+template <typename Iterator>
+auto entryKey(const Iterator &it, int) -> decltype(it.key())
+{
+    return it.key();
+}
+
+template <typename Iterator>
+auto entryKey(const Iterator &it, long) -> decltype((it->first))
+{
+    return it->first;
+}
+
+template <typename Iterator>
+auto entryValue(const Iterator &it, int) -> decltype(it.value())
+{
+    return it.value();
+}
+
+template <typename Iterator>
+auto entryValue(const Iterator &it, long) -> decltype((it->second))
+{
+    return it->second;
+}
+
+// Source buffer is reused if result is of the same type
+template <typename Result, typename Container>
+Result moveElements(Container &&container)
+{
+    static_assert(!std::is_lvalue_reference<Container>::value, "Only rvalue containers can be moved from");
+    if constexpr (std::is_same<Result, Container>::value) {
+        return std::move(container);
+    } else {
+        Result result;
+        reserveContainer(result, static_cast<long long>(container.size()));
+        if constexpr (IsImplicitlyShared<Container>::value) {
+            if (!container.isDetached()) {
+                for (const auto &x : qAsConst(container))
+                    addToContainer(result, x);
+                return result;
+            }
+        }
+        for (auto &x : container)
+            addToContainer(result, std::move(x));
+        return result;
+    }
+}
+
+// Keys of Qt associative containers are immutable and only std ones can give them away with node extraction
+template <typename Result, typename Container>
+Result moveKeys(Container &&container)
+{
+    static_assert(!std::is_lvalue_reference<Container>::value, "Only rvalue containers can be moved from");
+    Result result;
+    reserveContainer(result, static_cast<long long>(container.size()));
+    if constexpr (HasNodeExtract<Container>::value) {
+        while (!container.empty())
+            addToContainer(result, std::move(container.extract(container.begin()).key()));
+    } else {
+        for (auto it = container.cbegin(); it != container.cend(); ++it)
+            addToContainer(result, it.key());
+    }
+    return result;
+}
+
+template <typename Result, typename Container>
+Result moveValues(Container &&container)
+{
+    static_assert(!std::is_lvalue_reference<Container>::value, "Only rvalue containers can be moved from");
+    Result result;
+    reserveContainer(result, static_cast<long long>(container.size()));
+    if constexpr (IsImplicitlyShared<Container>::value) {
+        if (!container.isDetached()) {
+            for (auto it = container.cbegin(); it != container.cend(); ++it)
+                addToContainer(result, entryValue(it, 0));
+            return result;
+        }
+    }
+    for (auto it = container.begin(); it != container.end(); ++it)
+        addToContainer(result, std::move(entryValue(it, 0)));
+    return result;
+}
+
+template <typename Result, typename Container, typename Predicate>
+void moveFlattened(Container &&container, Result &destination, const Predicate &predicate)
+{
+    static_assert(!std::is_lvalue_reference<Container>::value, "Only rvalue containers can be moved from");
+    if constexpr (IsImplicitlyShared<Container>::value) {
+        if (!container.isDetached()) {
+            for (const auto &inner : qAsConst(container)) {
+                for (const auto &x : inner) {
+                    if (predicate(x))
+                        addToContainer(destination, x);
+                }
+            }
+            return;
+        }
+    }
+    for (auto &inner : container) {
+        if constexpr (IsImplicitlyShared<std::decay_t<decltype(inner)>>::value) {
+            if (!inner.isDetached()) {
+                for (const auto &x : qAsConst(inner)) {
+                    if (predicate(x))
+                        addToContainer(destination, x);
+                }
+                continue;
+            }
+        }
+        for (auto &x : inner) {
+            if (predicate(qAsConst(x)))
+                addToContainer(destination, std::move(x));
+        }
+    }
+}
+
 //TODO: remove this workaround with wrapper for const_cast after msvc fix its INTERNAL COMPILER ERROR
 template <typename T>
 T &constCastWrapper(const T &ref)
@@ -70,6 +326,15 @@ T &constCastWrapper(const T &ref)
 }
 } // namespace detail
 
+// Destination capacity management for algorithms with unknown result size.
+// UpperBound can waste a lot of memory for selective predicates, so it should be requested explicitly
+enum class ReserveMode
+{
+    None, // Destination grows as needed (default)
+    UpperBound, // Maximum possible size is reserved before filling
+    ShrinkToFit // Same as UpperBound, but unused capacity is released afterwards
+};
+
 using asynqro::traverse::filter;
 using asynqro::traverse::findIf;
 using asynqro::traverse::flatten;
@@ -101,6 +366,50 @@ void makeUnique(Container &container)
     container.erase(std::unique(container.begin(), container.end()), container.end());
 }
 
+// Removes all duplicates, not only consecutive ones, and keeps first occurrences in their original order
+template <typename Container, typename Hasher = detail::DefaultHasher,
+          typename = std::enable_if_t<detail::IsRandomAccess_V<Container>>>
+void makeDistinct(Container &container, const Hasher &hasher = Hasher())
+{
+    const long long size = static_cast<long long>(container.size());
+    if (size < 2)
+        return;
+    auto begin = container.begin();
+    const long long newSize = detail::withDistinctIndex(begin, size, hasher, [begin, size](auto &index) {
+        long long write = 0;
+        for (long long read = 0; read < size; ++read) {
+            auto it = begin + read;
+            if (!index.insert(*it, write))
+                continue;
+            if (write != read)
+                *(begin + write) = std::move(*it);
+            ++write;
+        }
+        return write;
+    });
+    container.erase(container.begin() + newSize, container.end());
+}
+
+// Only first occurrences are copied to result
+template <typename Container, typename Hasher = detail::DefaultHasher,
+          typename = std::enable_if_t<detail::IsRandomAccess_V<Container>>>
+Container distinct(const Container &container, const Hasher &hasher = Hasher())
+{
+    const long long size = static_cast<long long>(container.size());
+    if (size < 2)
+        return container;
+    auto begin = detail::beginIterator(container);
+    return detail::withDistinctIndex(begin, size, hasher, [begin, size](auto &index) {
+        Container result;
+        for (long long i = 0; i < size; ++i) {
+            auto it = begin + i;
+            if (index.insert(*it, i))
+                detail::addToContainer(result, *it);
+        }
+        return result;
+    });
+}
+
 //Non-socketed type without indices
 template <typename Container, typename Func,
           typename = typename std::enable_if_t<!asynqro::traverse::detail::HasTypeParams_V<Container>>>
@@ -277,6 +586,30 @@ auto forEach(const Container<InputKey, InputValue> &container, const Func &func)
         func(it.key(), it.value());
 }
 
+// Same as reduce, but func(acc, x) modifies accumulator in place instead of returning new one,
+// so accumulators that are expensive to move or copy (e.g. containers) are not passed around on each step
+template <typename Container, typename Func, typename Acc>
+auto reduceByMutation(const Container &container, const Func &func, Acc acc)
+    -> decltype(func(acc, *detail::beginIterator(container)), Acc())
+{
+    auto it = detail::beginIterator(container);
+    auto end = detail::endIterator(container);
+    for (; it != end; ++it)
+        func(acc, *it);
+    return acc;
+}
+
+template <typename Container, typename Func, typename Acc>
+auto reduceByMutation(const Container &container, const Func &func, Acc acc)
+    -> decltype(func(acc, detail::beginIterator(container).key(), detail::beginIterator(container).value()), Acc())
+{
+    auto it = detail::beginIterator(container);
+    auto end = detail::endIterator(container);
+    for (; it != end; ++it)
+        func(acc, it.key(), it.value());
+    return acc;
+}
+
 inline auto identity()
 {
     return [](const auto &x) { return x; };
@@ -369,10 +702,15 @@ QList<InputValue> toValuesList(const Container<InputKey, InputValue, Args...> &c
 
 template <template <typename...> class Container1, template <typename...> class Container2, typename Input,
           typename Predicate, typename Result>
-auto flatFilter(const Container1<Container2<Input>> &container, const Predicate &predicate, Result destination)
+auto flatFilter(const Container1<Container2<Input>> &container, const Predicate &predicate, Result destination,
+                ReserveMode reserveMode = ReserveMode::None)
     -> decltype(detail::addToContainer(destination, *detail::beginIterator(*detail::beginIterator(container))),
                 predicate(*detail::beginIterator(*detail::beginIterator(container))), Result())
 {
+    if (reserveMode != ReserveMode::None) {
+        detail::reserveContainer(destination,
+                                 static_cast<long long>(destination.size()) + detail::flattenedSize(container));
+    }
     auto outerIt = detail::beginIterator(container);
     auto outerEnd = detail::endIterator(container);
     for (; outerIt != outerEnd; ++outerIt) {
@@ -383,13 +721,184 @@ auto flatFilter(const Container1<Container2<Input>> &container, const Predicate
                 detail::addToContainer(destination, *it);
         }
     }
+    if (reserveMode == ReserveMode::ShrinkToFit)
+        detail::shrinkContainer(destination, 0);
     return destination;
 }
 
 template <template <typename...> class Container1, template <typename...> class Container2, typename Input, typename Predicate>
-Container1<Input> flatFilter(const Container1<Container2<Input>> &container, const Predicate &predicate)
+Container1<Input> flatFilter(const Container1<Container2<Input>> &container, const Predicate &predicate,
+                             ReserveMode reserveMode = ReserveMode::None)
+{
+    return flatFilter(container, predicate, Container1<Input>(), reserveMode);
+}
+
+// Rvalue overloads. Elements are moved out of source container and its buffer is reused when result has the same type.
+// Implicitly shared containers that are not detached are processed the same way as const ones.
+template <template <typename...> class Container, typename Input, typename Func, typename... Args,
+          typename Output = std::decay_t<decltype(std::declval<Func &>()(std::declval<Input>()))>,
+          typename = std::enable_if_t<std::is_same<std::decay_t<decltype(*std::declval<Container<Input, Args...> &>().begin())>, Input>::value>>
+Container<Output> map(Container<Input, Args...> &&container, Func &&func)
+{
+    if constexpr (detail::IsImplicitlyShared<Container<Input, Args...>>::value) {
+        if (!container.isDetached())
+            return map(qAsConst(container), std::forward<Func>(func));
+    }
+    if constexpr (std::is_same<Container<Output>, Container<Input, Args...>>::value
+                  && std::is_assignable<decltype(*container.begin()), Output>::value) {
+        for (auto &x : container)
+            x = func(std::move(x));
+        return std::move(container);
+    } else {
+        Container<Output> result;
+        detail::reserveContainer(result, static_cast<long long>(container.size()));
+        for (auto &x : container)
+            detail::addToContainer(result, func(std::move(x)));
+        return result;
+    }
+}
+
+template <typename Container, typename Func, typename Result,
+          typename = std::enable_if_t<!std::is_lvalue_reference<Container>::value>>
+auto map(Container &&container, Func &&func, Result destination)
+    -> decltype(detail::addToContainer(destination, func(std::move(*container.begin()))), Result())
+{
+    if constexpr (detail::IsImplicitlyShared<Container>::value) {
+        if (!container.isDetached())
+            return map(qAsConst(container), std::forward<Func>(func), std::move(destination));
+    }
+    detail::reserveContainer(destination, static_cast<long long>(container.size()));
+    for (auto &x : container)
+        detail::addToContainer(destination, func(std::move(x)));
+    return destination;
+}
+
+template <typename Container, typename Predicate,
+          typename = std::enable_if_t<!std::is_lvalue_reference<Container>::value && detail::IsRandomAccess_V<Container>>>
+auto filter(Container &&container, Predicate &&predicate) -> decltype(predicate(qAsConst(*container.begin())), Container())
+{
+    if constexpr (detail::IsImplicitlyShared<Container>::value) {
+        if (!container.isDetached())
+            return filter(qAsConst(container), std::forward<Predicate>(predicate));
+    }
+    eraseIf(container, [&predicate](const auto &x) { return !predicate(x); });
+    return std::move(container);
+}
+
+template <template <typename...> class Container1, template <typename...> class Container2, typename Input, typename Result>
+Result flatten(Container1<Container2<Input>> &&container, Result destination)
+{
+    detail::reserveContainer(destination, static_cast<long long>(destination.size()) + detail::flattenedSize(container));
+    detail::moveFlattened(std::move(container), destination, [](const auto &) { return true; });
+    return destination;
+}
+
+template <template <typename...> class Container1, template <typename...> class Container2, typename Input>
+Container1<Input> flatten(Container1<Container2<Input>> &&container)
+{
+    return flatten(std::move(container), Container1<Input>());
+}
+
+template <template <typename...> class Container1, template <typename...> class Container2, typename Input,
+          typename Predicate, typename Result>
+auto flatFilter(Container1<Container2<Input>> &&container, const Predicate &predicate, Result destination,
+                ReserveMode reserveMode = ReserveMode::None)
+    -> decltype(detail::addToContainer(destination, std::declval<Input>()), predicate(std::declval<const Input &>()),
+                Result())
+{
+    if (reserveMode != ReserveMode::None) {
+        detail::reserveContainer(destination,
+                                 static_cast<long long>(destination.size()) + detail::flattenedSize(container));
+    }
+    detail::moveFlattened(std::move(container), destination, predicate);
+    if (reserveMode == ReserveMode::ShrinkToFit)
+        detail::shrinkContainer(destination, 0);
+    return destination;
+}
+
+template <template <typename...> class Container1, template <typename...> class Container2, typename Input, typename Predicate>
+Container1<Input> flatFilter(Container1<Container2<Input>> &&container, const Predicate &predicate,
+                             ReserveMode reserveMode = ReserveMode::None)
+{
+    return flatFilter(std::move(container), predicate, Container1<Input>(), reserveMode);
+}
+
+template <typename Container, typename Input = typename Container::value_type,
+          typename = typename std::enable_if_t<!std::is_lvalue_reference<Container>::value
+                                               && !asynqro::traverse::detail::HasTypeParams_V<Container>>>
+QSet<Input> toSet(Container &&container)
+{
+    return detail::moveElements<QSet<Input>>(std::move(container));
+}
+
+template <typename Container, typename Input = typename Container::value_type,
+          typename = typename std::enable_if_t<!std::is_lvalue_reference<Container>::value
+                                               && !asynqro::traverse::detail::HasTypeParams_V<Container>>>
+QVector<Input> toVector(Container &&container)
+{
+    return detail::moveElements<QVector<Input>>(std::move(container));
+}
+
+template <typename Container, typename Input = typename Container::value_type,
+          typename = typename std::enable_if_t<!std::is_lvalue_reference<Container>::value
+                                               && !asynqro::traverse::detail::HasTypeParams_V<Container>>>
+QList<Input> toList(Container &&container)
+{
+    return detail::moveElements<QList<Input>>(std::move(container));
+}
+
+template <template <typename...> class Container, typename Input>
+QSet<Input> toSet(Container<Input> &&container)
+{
+    return detail::moveElements<QSet<Input>>(std::move(container));
+}
+
+template <template <typename...> class Container, typename Input>
+QVector<Input> toVector(Container<Input> &&container)
+{
+    return detail::moveElements<QVector<Input>>(std::move(container));
+}
+
+template <template <typename...> class Container, typename Input>
+QList<Input> toList(Container<Input> &&container)
+{
+    return detail::moveElements<QList<Input>>(std::move(container));
+}
+
+template <template <typename...> class Container, typename InputKey, typename InputValue, typename... Args>
+QSet<InputKey> toKeysSet(Container<InputKey, InputValue, Args...> &&container)
+{
+    return detail::moveKeys<QSet<InputKey>>(std::move(container));
+}
+
+template <template <typename...> class Container, typename InputKey, typename InputValue, typename... Args>
+QVector<InputKey> toKeysVector(Container<InputKey, InputValue, Args...> &&container)
+{
+    return detail::moveKeys<QVector<InputKey>>(std::move(container));
+}
+
+template <template <typename...> class Container, typename InputKey, typename InputValue, typename... Args>
+QList<InputKey> toKeysList(Container<InputKey, InputValue, Args...> &&container)
+{
+    return detail::moveKeys<QList<InputKey>>(std::move(container));
+}
+
+template <template <typename...> class Container, typename InputKey, typename InputValue, typename... Args>
+QSet<InputValue> toValuesSet(Container<InputKey, InputValue, Args...> &&container)
+{
+    return detail::moveValues<QSet<InputValue>>(std::move(container));
+}
+
+template <template <typename...> class Container, typename InputKey, typename InputValue, typename... Args>
+QVector<InputValue> toValuesVector(Container<InputKey, InputValue, Args...> &&container)
+{
+    return detail::moveValues<QVector<InputValue>>(std::move(container));
+}
+
+template <template <typename...> class Container, typename InputKey, typename InputValue, typename... Args>
+QList<InputValue> toValuesList(Container<InputKey, InputValue, Args...> &&container)
 {
-    return flatFilter(container, predicate, Container1<Input>());
+    return detail::moveValues<QList<InputValue>>(std::move(container));
 }
 
 //extract tuple from tuple
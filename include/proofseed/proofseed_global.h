@@ -29,10 +29,23 @@
 
 #include <QtGlobal>
 
+#include <atomic>
+
 #ifdef Proof_Seed_EXPORTS
 #    define PROOF_SEED_EXPORT Q_DECL_EXPORT
 #else
 #    define PROOF_SEED_EXPORT Q_DECL_IMPORT
 #endif
 
+namespace Proof {
+namespace detail {
+// For counters written only by one thread at a time plain load+store is enough instead of atomic increment
+template <typename T>
+inline void bumpOwnedCounter(std::atomic<T> &counter, std::memory_order order = std::memory_order_relaxed) noexcept
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1, order);
+}
+} // namespace detail
+} // namespace Proof
+
 #endif // PROOFSEED_GLOBAL_H
@@ -0,0 +1,244 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_READYFUTURE_H
+#define PROOFSEED_READYFUTURE_H
+
+#include "proofseed/asynqro_extra.h"
+
+#include <type_traits>
+#include <variant>
+
+namespace Proof {
+template <typename T>
+class ReadyFuture;
+
+namespace detail {
+template <typename T>
+struct IsReadyFuture : std::false_type
+{};
+
+template <typename T>
+struct IsReadyFuture<ReadyFuture<T>> : std::true_type
+{};
+} // namespace detail
+
+// Future that keeps already known result or failure inline and wraps Proof::Future only if result is not known yet.
+// Transformations of completed values (including completed wrapped futures) are executed in place,
+// without shared state allocation and callbacks registration. Shared state is created only if continuation
+// has to wait or if ReadyFuture is converted to Proof::Future.
+template <typename T>
+class ReadyFuture
+{
+    static_assert(!std::is_same_v<T, Failure>, "ReadyFuture can't hold Failure as value");
+
+public:
+    using Value = T;
+
+    ReadyFuture(const Proof::Future<T> &future) : m_data(std::in_place_index<PENDING>, future) {}
+    ReadyFuture(Proof::Future<T> &&future) : m_data(std::in_place_index<PENDING>, std::move(future)) {}
+
+    static ReadyFuture successful(T value) noexcept
+    {
+        return ReadyFuture(std::in_place_index<SUCCEEDED>, std::move(value));
+    }
+    static ReadyFuture failed(Failure failure) noexcept
+    {
+        return ReadyFuture(std::in_place_index<FAILED>, std::move(failure));
+    }
+
+    bool isCompleted() const noexcept { return m_data.index() != PENDING || pending().isCompleted(); }
+    bool isSucceeded() const noexcept
+    {
+        return m_data.index() == SUCCEEDED || (m_data.index() == PENDING && pending().isSucceeded());
+    }
+    bool isFailed() const noexcept
+    {
+        return m_data.index() == FAILED || (m_data.index() == PENDING && pending().isFailed());
+    }
+    // Doesn't create shared state for already known result
+    bool isInline() const noexcept { return m_data.index() != PENDING; }
+
+    // Same as in Proof::Future, waits for pending result and should be called only if future is succeeded
+    const T &resultRef() const
+    {
+        if (m_data.index() == PENDING)
+            return pending().resultRef();
+        Q_ASSERT(m_data.index() == SUCCEEDED);
+        return std::get<SUCCEEDED>(m_data);
+    }
+    T result() const { return resultRef(); }
+
+    Failure failureReason() const
+    {
+        switch (m_data.index()) {
+        case FAILED:
+            return std::get<FAILED>(m_data);
+        case PENDING:
+            return pending().failureReason();
+        default:
+            return Failure();
+        }
+    }
+
+    bool wait(long long timeout = -1) const { return m_data.index() != PENDING || pending().wait(timeout); }
+
+    Proof::Future<T> future() const
+    {
+        switch (m_data.index()) {
+        case SUCCEEDED:
+            return Proof::Future<T>::successful(std::get<SUCCEEDED>(m_data));
+        case FAILED:
+            return Proof::Future<T>::failed(std::get<FAILED>(m_data));
+        default:
+            return pending();
+        }
+    }
+    operator Proof::Future<T>() const { return future(); }
+
+    // Void returning func is mapped to bool, same as in tasks::run
+    template <typename Func, typename Raw = std::decay_t<std::invoke_result_t<Func, const T &>>,
+              typename Result = std::conditional_t<std::is_void_v<Raw>, bool, Raw>>
+    ReadyFuture<Result> map(Func &&f) const
+    {
+        if constexpr (std::is_void_v<Raw>) {
+            return map([f = std::forward<Func>(f)](const T &x) mutable {
+                f(x);
+                return true;
+            });
+        } else {
+            if (const T *value = completedValue())
+                return invoke<Result>([&f, value]() { return ReadyFuture<Result>::successful(f(*value)); });
+            if (isFailed())
+                return ReadyFuture<Result>::failed(failureReason());
+            return ReadyFuture<Result>(pending().map(std::forward<Func>(f)));
+        }
+    }
+
+    // Func can return either Proof::Future or ReadyFuture
+    template <typename Func, typename Raw = std::decay_t<std::invoke_result_t<Func, const T &>>,
+              typename Result = typename Raw::Value>
+    ReadyFuture<Result> flatMap(Func &&f) const
+    {
+        if (const T *value = completedValue())
+            return invoke<Result>([&f, value]() { return ReadyFuture<Result>(f(*value)); });
+        if (isFailed())
+            return ReadyFuture<Result>::failed(failureReason());
+        if constexpr (detail::IsReadyFuture<Raw>::value) {
+            return ReadyFuture<Result>(pending().flatMap(
+                [f = std::forward<Func>(f)](const T &x) { return Proof::Future<Result>(f(x)); }));
+        } else {
+            return ReadyFuture<Result>(pending().flatMap(std::forward<Func>(f)));
+        }
+    }
+
+    template <typename Func>
+    ReadyFuture<T> recover(Func &&f) const
+    {
+        if (m_data.index() == SUCCEEDED || (m_data.index() == PENDING && pending().isSucceeded()))
+            return *this;
+        if (m_data.index() == FAILED || pending().isFailed()) {
+            const Failure failure = failureReason();
+            return invoke<T>([&f, &failure]() { return ReadyFuture<T>::successful(f(failure)); });
+        }
+        return ReadyFuture<T>(pending().recover(std::forward<Func>(f)));
+    }
+
+    template <typename Func>
+    const ReadyFuture &onSuccess(Func &&f) const
+    {
+        if (const T *value = completedValue())
+            f(*value);
+        else if (m_data.index() == PENDING && !pending().isFailed())
+            pending().onSuccess(std::forward<Func>(f));
+        return *this;
+    }
+
+    template <typename Func>
+    const ReadyFuture &onFailure(Func &&f) const
+    {
+        if (m_data.index() == FAILED)
+            f(std::get<FAILED>(m_data));
+        else if (m_data.index() == PENDING)
+            pending().onFailure(std::forward<Func>(f));
+        return *this;
+    }
+
+private:
+    template <typename>
+    friend class ReadyFuture;
+
+    static constexpr size_t SUCCEEDED = 0;
+    static constexpr size_t FAILED = 1;
+    static constexpr size_t PENDING = 2;
+
+    template <size_t index, typename... Args>
+    ReadyFuture(std::in_place_index_t<index> tag, Args &&... args) : m_data(tag, std::forward<Args>(args)...)
+    {}
+
+    const Proof::Future<T> &pending() const { return std::get<PENDING>(m_data); }
+
+    const T *completedValue() const noexcept
+    {
+        if (m_data.index() == SUCCEEDED)
+            return &std::get<SUCCEEDED>(m_data);
+        if (m_data.index() == PENDING && pending().isSucceeded())
+            return &pending().resultRef();
+        return nullptr;
+    }
+
+    template <typename Result, typename Func>
+    static ReadyFuture<Result> invoke(Func &&f) noexcept
+    {
+        try {
+            return f();
+        } catch (...) {
+            return ReadyFuture<Result>::failed(detail::failureFromCurrentException());
+        }
+    }
+
+    std::variant<T, Failure, Proof::Future<T>> m_data;
+};
+
+namespace futures {
+template <typename T>
+auto ready(T &&value) noexcept
+{
+    if constexpr (tasks::detail::IsProofFuture<std::decay_t<T>>::value)
+        return ReadyFuture<typename std::decay_t<T>::Value>(std::forward<T>(value));
+    else
+        return ReadyFuture<std::decay_t<T>>::successful(std::forward<T>(value));
+}
+
+template <typename T>
+ReadyFuture<T> readyFailure(Failure failure) noexcept
+{
+    return ReadyFuture<T>::failed(std::move(failure));
+}
+} // namespace futures
+} // namespace Proof
+
+#endif // PROOFSEED_READYFUTURE_H
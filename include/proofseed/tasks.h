@@ -27,15 +27,249 @@
 #ifndef PROOF_TASKS_H
 #define PROOF_TASKS_H
 
+#include "proofseed/asynqro_extra.h"
+#include "proofseed/memorypool.h"
 #include "proofseed/proofseed_global.h"
+#include "proofseed/uniquefunction.h"
 
 #include <QEventLoop>
+#include <QMetaMethod>
+#include <QPair>
 #include <QSharedPointer>
+#include <QTimer>
+#include <QVector>
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <list>
+#include <tuple>
+#include <typeindex>
 
 namespace Proof {
 namespace tasks {
+namespace detail {
+class SignalMultiplexerBase;
+
+class PROOF_SEED_EXPORT SignalWaiterBase
+{
+public:
+    SignalWaiterBase() = default;
+    SignalWaiterBase(const SignalWaiterBase &) = delete;
+    SignalWaiterBase(SignalWaiterBase &&) = delete;
+    SignalWaiterBase &operator=(const SignalWaiterBase &) = delete;
+    SignalWaiterBase &operator=(SignalWaiterBase &&) = delete;
+    virtual ~SignalWaiterBase() = default;
+
+    bool isDone() const { return m_done; }
+    // Returns true only for the first caller
+    bool markDone() { return !m_done.exchange(true); }
+
+    // Direct waiters are notified in emitting thread, others - by queued call in thread of their context object
+    virtual bool isDirect() const { return true; }
+    virtual QSharedPointer<QObject> context() const { return QSharedPointer<QObject>(); }
+    virtual void senderDestroyed() noexcept {}
+
+private:
+    friend class SignalWaitersRegistry;
+    std::atomic_bool m_done{false};
+    SignalMultiplexerBase *m_multiplexer = nullptr;
+    std::list<QSharedPointer<SignalWaiterBase>>::iterator m_position;
+};
+
+template <typename... Args>
+class SignalWaiter : public SignalWaiterBase
+{
+public:
+    virtual void notify(std::decay_t<Args> &... args) = 0;
+};
+
+// Single connection to (sender, signal) shared by all waiters with same arguments
+class PROOF_SEED_EXPORT SignalMultiplexerBase
+{
+public:
+    SignalMultiplexerBase(QObject *sender, int signalIndex, std::type_index argsType)
+        : m_sender(sender), m_signalIndex(signalIndex), m_argsType(argsType)
+    {}
+    SignalMultiplexerBase(const SignalMultiplexerBase &) = delete;
+    SignalMultiplexerBase(SignalMultiplexerBase &&) = delete;
+    SignalMultiplexerBase &operator=(const SignalMultiplexerBase &) = delete;
+    SignalMultiplexerBase &operator=(SignalMultiplexerBase &&) = delete;
+    virtual ~SignalMultiplexerBase() = default;
+
+protected:
+    friend class SignalWaitersRegistry;
+    QObject *m_sender;
+    int m_signalIndex;
+    std::type_index m_argsType;
+    QMetaObject::Connection m_signalConnection;
+    QMetaObject::Connection m_destroyedConnection;
+    SpinLock m_waitersLock;
+    std::list<QSharedPointer<SignalWaiterBase>> m_waiters;
+};
+
+// Waiters are removed in O(1) and multiplexer is disconnected and dropped together with its last waiter
+class PROOF_SEED_EXPORT SignalWaitersRegistry
+{
+public:
+    SignalWaitersRegistry() = delete;
+    SignalWaitersRegistry(const SignalWaitersRegistry &) = delete;
+    SignalWaitersRegistry(SignalWaitersRegistry &&) = delete;
+    SignalWaitersRegistry &operator=(const SignalWaitersRegistry &) = delete;
+    SignalWaitersRegistry &operator=(SignalWaitersRegistry &&) = delete;
+    ~SignalWaitersRegistry() = delete;
+
+    static void addWaiter(QObject *sender, int signalIndex, std::type_index argsType,
+                          const QSharedPointer<SignalWaiterBase> &waiter,
+                          const UniqueFunction<QSharedPointer<SignalMultiplexerBase>()> &multiplexerCreator);
+    static void removeWaiter(SignalWaiterBase *waiter) noexcept;
+    static void senderDestroyed(SignalMultiplexerBase *multiplexer) noexcept;
+    static qint64 multiplexersCount() noexcept;
+};
+
+template <typename... Args>
+class SignalMultiplexer : public SignalMultiplexerBase
+{
+public:
+    using SignalMultiplexerBase::SignalMultiplexerBase;
+
+    template <typename SignalSender, typename SignalType>
+    static void addWaiter(SignalSender *sender, SignalType signal, const QSharedPointer<SignalWaiter<Args...>> &waiter)
+    {
+        int signalIndex = QMetaMethod::fromSignal(signal).methodIndex();
+        SignalWaitersRegistry::addWaiter(sender, signalIndex, argsType(), waiter, [sender, signal, signalIndex]() {
+            return SignalMultiplexer::create(sender, signal, signalIndex);
+        });
+    }
+
+private:
+    static std::type_index argsType() { return std::type_index(typeid(std::tuple<std::decay_t<Args>...>)); }
+
+    template <typename SignalSender, typename SignalType>
+    static QSharedPointer<SignalMultiplexerBase> create(SignalSender *sender, SignalType signal, int signalIndex)
+    {
+        auto result = QSharedPointer<SignalMultiplexer>::create(sender, signalIndex, argsType());
+        QWeakPointer<SignalMultiplexer> weakResult = result.toWeakRef();
+        result->m_signalConnection = QObject::connect(sender, signal, [weakResult](Args... args) {
+            auto multiplexer = weakResult.toStrongRef();
+            if (multiplexer)
+                multiplexer->dispatch(args...);
+        });
+        result->m_destroyedConnection = QObject::connect(sender, &QObject::destroyed, [weakResult]() {
+            auto multiplexer = weakResult.toStrongRef();
+            if (multiplexer)
+                SignalWaitersRegistry::senderDestroyed(multiplexer.data());
+        });
+        return result;
+    }
+
+    void dispatch(std::decay_t<Args>... args)
+    {
+        using Waiter = SignalWaiter<Args...>;
+        QVector<QSharedPointer<Waiter>> direct;
+        QVector<QPair<QSharedPointer<QObject>, QVector<QSharedPointer<Waiter>>>> queued;
+        {
+            SpinLockHolder lock(&m_waitersLock);
+            for (const auto &waiter : m_waiters) {
+                if (waiter->isDone())
+                    continue;
+                auto typedWaiter = waiter.template staticCast<Waiter>();
+                if (waiter->isDirect()) {
+                    direct << typedWaiter;
+                    continue;
+                }
+                auto context = waiter->context();
+                if (!context)
+                    continue;
+                auto group = std::find_if(queued.begin(), queued.end(),
+                                          [&context](const auto &x) { return x.first == context; });
+                if (group == queued.end())
+                    queued << qMakePair(context, QVector<QSharedPointer<Waiter>>{typedWaiter});
+                else
+                    group->second << typedWaiter;
+            }
+        }
+
+        if (!queued.isEmpty()) {
+            auto sharedArgs = makePooledShared<std::tuple<std::decay_t<Args>...>>(args...);
+            for (auto &group : queued) {
+                QObject *target = group.first.data();
+                // Context reference is moved to queued call, so it is released in context thread
+                QMetaObject::invokeMethod(target,
+                                          [context = std::move(group.first), waiters = std::move(group.second),
+                                           sharedArgs]() {
+                                              for (const auto &waiter : waiters) {
+                                                  if (waiter->isDone())
+                                                      continue;
+                                                  std::apply([&waiter](auto &... args) { waiter->notify(args...); },
+                                                             *sharedArgs);
+                                              }
+                                          },
+                                          Qt::QueuedConnection);
+            }
+        }
+
+        for (const auto &waiter : direct)
+            waiter->notify(args...);
+    }
+};
+
+template <typename... Args>
+class SignalFutureWaiter : public SignalWaiter<Args...>
+{
+public:
+    explicit SignalFutureWaiter(UniqueFunction<bool(Args...)> &&predicate) : m_predicate(std::move(predicate)) {}
+
+    Future<bool> future() const { return m_promise.future(); }
+
+    void notify(std::decay_t<Args> &... args) override
+    {
+        if (this->isDone())
+            return;
+        try {
+            if (!m_predicate(args...))
+                return;
+        } catch (...) {
+            fail(Proof::detail::failureFromCurrentException());
+            return;
+        }
+        if (!this->markDone())
+            return;
+        SignalWaitersRegistry::removeWaiter(this);
+        m_promise.success(true);
+    }
+
+    void senderDestroyed() noexcept override { fail(Failure(QStringLiteral("Signal sender destroyed"), 0, 0)); }
+
+    void fail(const Failure &failure)
+    {
+        if (!this->markDone())
+            return;
+        SignalWaitersRegistry::removeWaiter(this);
+        m_promise.failure(failure);
+    }
+
+private:
+    UniqueFunction<bool(Args...)> m_predicate;
+    Promise<bool> m_promise;
+};
+
+template <typename... Args>
+class EventLoopSignalWaiter;
+
+template <typename T>
+struct IsStdFunction : std::false_type
+{};
+
+template <typename Signature>
+struct IsStdFunction<std::function<Signature>> : std::true_type
+{};
+
+// Closures passed directly (not wrapped into std::function) take signal arguments as they are declared
+template <typename Callback, typename... Args>
+constexpr bool IsSignalCallback_V = !IsStdFunction<std::decay_t<Callback>>::value
+                                    && std::is_invocable_r_v<bool, std::decay_t<Callback> &, Args...>;
+} // namespace detail
 
 class PROOF_SEED_EXPORT TasksExtra
 {
@@ -50,49 +284,171 @@ public:
     template <class SignalSender, class SignalType, class... Args>
     static void addSignalWaiter(SignalSender *sender, SignalType signal, std::function<bool(Args...)> callback) noexcept
     {
-        std::function<void(const QSharedPointer<QEventLoop> &)> connector = [sender, signal, callback](
-            const QSharedPointer<QEventLoop> &eventLoop) noexcept
-        {
-            auto connection = QSharedPointer<QMetaObject::Connection>::create();
-            auto eventLoopWeak = eventLoop.toWeakRef();
-            std::function<void(Args...)> slot = [callback, eventLoopWeak, connection](Args... args) {
-                QSharedPointer<QEventLoop> eventLoop = eventLoopWeak.toStrongRef();
-                if (!eventLoop)
-                    return;
-                try {
-                    if (!callback(args...))
-                        return;
-                } catch (...) {
-                }
-                QObject::disconnect(*connection);
-                if (!eventLoopStarted())
-                    clearEventLoop();
-                else
-                    eventLoop->quit();
-            };
-            *connection = QObject::connect(sender, signal, eventLoop.data(), slot, Qt::QueuedConnection);
-        };
-        addSignalWaiterPrivate(std::move(connector));
+        addSignalWaiterImpl(sender, signal, UniqueFunction<bool(Args...)>(std::move(callback)));
+    }
+
+    template <class SignalSender, class Sender, class... Args, class Callback,
+              typename = std::enable_if_t<detail::IsSignalCallback_V<Callback, Args...>>>
+    static void addSignalWaiter(SignalSender *sender, void (Sender::*signal)(Args...), Callback &&callback) noexcept
+    {
+        try {
+            addSignalWaiterImpl(sender, signal, UniqueFunction<bool(Args...)>(std::forward<Callback>(callback)));
+        } catch (...) {
+        }
+    }
+
+    // Doesn't occupy any thread while waiting. Predicate is called and future is resolved in thread that emits signal.
+    // Timeout is in msecs (negative means no timeout) and is measured by timer in sender thread,
+    // so this thread should have running event loop.
+    // Future fails on timeout, on sender destruction and if predicate throws.
+    template <class SignalSender, class SignalType, class... Args>
+    static Future<bool> signalFuture(SignalSender *sender, SignalType signal, std::function<bool(Args...)> predicate,
+                                     qint64 timeout) noexcept
+    {
+        return signalFutureImpl(sender, signal, UniqueFunction<bool(Args...)>(std::move(predicate)), timeout);
+    }
+
+    template <class SignalSender, class Sender, class... Args, class Predicate,
+              typename = std::enable_if_t<detail::IsSignalCallback_V<Predicate, Args...>>>
+    static Future<bool> signalFuture(SignalSender *sender, void (Sender::*signal)(Args...), Predicate &&predicate,
+                                     qint64 timeout) noexcept
+    {
+        try {
+            return signalFutureImpl(sender, signal, UniqueFunction<bool(Args...)>(std::forward<Predicate>(predicate)),
+                                    timeout);
+        } catch (...) {
+            return Future<bool>::failed(Proof::detail::failureFromCurrentException());
+        }
     }
 
     static void fireSignalWaiters() noexcept;
 
 private:
-    static void addSignalWaiterPrivate(std::function<void(const QSharedPointer<QEventLoop> &)> &&connector) noexcept;
+    template <typename... Args>
+    friend class detail::EventLoopSignalWaiter;
+
+    template <class SignalSender, class SignalType, class... Args>
+    static void addSignalWaiterImpl(SignalSender *sender, SignalType signal, UniqueFunction<bool(Args...)> &&callback) noexcept
+    {
+        try {
+            auto waiter = QSharedPointer<detail::EventLoopSignalWaiter<Args...>>::create(currentSignalWaitersEventLoop(),
+                                                                                        std::move(callback));
+            trackSignalWaiter(waiter);
+            detail::SignalMultiplexer<Args...>::addWaiter(sender, signal, waiter);
+        } catch (...) {
+        }
+    }
+
+    template <class SignalSender, class SignalType, class... Args>
+    static Future<bool> signalFutureImpl(SignalSender *sender, SignalType signal,
+                                         UniqueFunction<bool(Args...)> &&predicate, qint64 timeout) noexcept
+    {
+        if (!sender)
+            return Future<bool>::failed(Failure(QStringLiteral("Signal sender is null"), 0, 0));
+        auto waiter = QSharedPointer<detail::SignalFutureWaiter<Args...>>::create(std::move(predicate));
+        Future<bool> result = waiter->future();
+        try {
+            detail::SignalMultiplexer<Args...>::addWaiter(sender, signal, waiter);
+        } catch (...) {
+            waiter->fail(Proof::detail::failureFromCurrentException());
+            return result;
+        }
+
+        if (timeout >= 0) {
+            auto weakWaiter = waiter.toWeakRef();
+            QMetaObject::invokeMethod(sender,
+                                      [sender, weakWaiter, timeout]() {
+                                          if (weakWaiter.isNull())
+                                              return;
+                                          QTimer::singleShot(static_cast<int>(timeout), sender, [weakWaiter]() {
+                                              auto waiter = weakWaiter.toStrongRef();
+                                              if (waiter)
+                                                  waiter->fail(Failure(QStringLiteral("Signal waiting timeout"), 0, 0));
+                                          });
+                                      },
+                                      Qt::QueuedConnection);
+        }
+        return result;
+    }
+
+    static QSharedPointer<QEventLoop> currentSignalWaitersEventLoop();
+    static void trackSignalWaiter(const QSharedPointer<detail::SignalWaiterBase> &waiter);
+    static void signalWaiterSatisfied() noexcept;
     static bool eventLoopStarted() noexcept;
     static void clearEventLoop() noexcept;
 };
 
+namespace detail {
+template <typename... Args>
+class EventLoopSignalWaiter : public SignalWaiter<Args...>
+{
+public:
+    EventLoopSignalWaiter(const QSharedPointer<QEventLoop> &eventLoop, UniqueFunction<bool(Args...)> &&callback)
+        : m_eventLoop(eventLoop.toWeakRef()), m_callback(std::move(callback))
+    {}
+
+    bool isDirect() const override { return false; }
+    QSharedPointer<QObject> context() const override { return m_eventLoop.toStrongRef(); }
+
+    // Called in event loop thread, all waiters of this loop are marked as done there when it is cleared or quits
+    void notify(std::decay_t<Args> &... args) override
+    {
+        if (this->isDone())
+            return;
+        try {
+            if (!m_callback(args...))
+                return;
+        } catch (...) {
+        }
+        TasksExtra::signalWaiterSatisfied();
+    }
+
+private:
+    QWeakPointer<QEventLoop> m_eventLoop;
+    UniqueFunction<bool(Args...)> m_callback;
+};
+} // namespace detail
+
 template <typename SignalSender, typename SignalType, typename... Args>
 void addSignalWaiter(SignalSender *sender, SignalType signal, std::function<bool(Args...)> callback) noexcept
 {
-    TasksExtra::addSignalWaiter(sender, signal, callback);
+    TasksExtra::addSignalWaiter(sender, signal, std::move(callback));
+}
+
+template <typename SignalSender, typename Sender, typename... Args, typename Callback,
+          typename = std::enable_if_t<detail::IsSignalCallback_V<Callback, Args...>>>
+void addSignalWaiter(SignalSender *sender, void (Sender::*signal)(Args...), Callback &&callback) noexcept
+{
+    TasksExtra::addSignalWaiter(sender, signal, std::forward<Callback>(callback));
 }
 
 inline void fireSignalWaiters() noexcept
 {
     TasksExtra::fireSignalWaiters();
 }
+
+template <typename SignalSender, typename SignalType, typename... Args>
+Future<bool> signalFuture(SignalSender *sender, SignalType signal, std::function<bool(Args...)> predicate,
+                          qint64 timeout = -1) noexcept
+{
+    return TasksExtra::signalFuture(sender, signal, std::move(predicate), timeout);
+}
+
+// Predicate takes all arguments of signal, same as they are declared in it
+template <typename SignalSender, typename Sender, typename... Args, typename Predicate,
+          typename = std::enable_if_t<detail::IsSignalCallback_V<Predicate, Args...>>>
+Future<bool> signalFuture(SignalSender *sender, void (Sender::*signal)(Args...), Predicate &&predicate,
+                          qint64 timeout = -1) noexcept
+{
+    return TasksExtra::signalFuture(sender, signal, std::forward<Predicate>(predicate), timeout);
+}
+
+// Resolves on first signal emission
+template <typename SignalSender, typename SignalType>
+Future<bool> signalFuture(SignalSender *sender, SignalType signal, qint64 timeout = -1) noexcept
+{
+    return TasksExtra::signalFuture(sender, signal, std::function<bool()>([]() { return true; }), timeout);
+}
 } // namespace tasks
 } // namespace Proof
 
@@ -0,0 +1,200 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_TASKSMETRICS_H
+#define PROOFSEED_TASKSMETRICS_H
+
+#include "proofseed/proofseed_global.h"
+
+#include "asynqro/asynqro"
+
+#include <QVector>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+namespace Proof {
+namespace tasks {
+struct TasksHistogram
+{
+    static constexpr int BUCKETS_COUNT = 32;
+    // Bucket 0 counts durations below 1 microsecond, bucket N counts durations in [2^(N-1), 2^N) microseconds
+    std::array<long long, BUCKETS_COUNT> buckets{};
+
+    long long count() const noexcept
+    {
+        long long result = 0;
+        for (long long x : buckets)
+            result += x;
+        return result;
+    }
+
+    // Upper bound (in microseconds) of bucket where requested percentile lies
+    long long percentile(double p) const noexcept
+    {
+        const long long total = count();
+        if (!total)
+            return 0;
+        const auto threshold = static_cast<long long>(static_cast<double>(total) * p / 100.0);
+        long long accumulated = 0;
+        for (int i = 0; i < BUCKETS_COUNT; ++i) {
+            accumulated += buckets[static_cast<size_t>(i)];
+            if (accumulated > threshold || accumulated == total)
+                return 1ll << i;
+        }
+        return 1ll << (BUCKETS_COUNT - 1);
+    }
+};
+
+// Metrics of tasks with the same type, tag and priority.
+// Waiting time is measured from task submission till its start, execution time doesn't include
+// time spent in futures returned by task.
+struct TasksGroupMetrics
+{
+    asynqro::tasks::TaskType type = asynqro::tasks::TaskType::Intensive;
+    int32_t tag = 0;
+    asynqro::tasks::TaskPriority priority = asynqro::tasks::TaskPriority::Regular;
+    long long queued = 0;
+    long long running = 0;
+    long long finished = 0;
+    TasksHistogram waitTime;
+    TasksHistogram execTime;
+};
+
+namespace detail {
+// Every thread has its own set of counters and only this thread writes to them
+struct alignas(64) TaskCounters
+{
+    std::atomic<long long> enqueued{0};
+    std::atomic<long long> started{0};
+    std::atomic<long long> finished{0};
+    std::array<std::atomic<long long>, TasksHistogram::BUCKETS_COUNT> waitTime{};
+    std::array<std::atomic<long long>, TasksHistogram::BUCKETS_COUNT> execTime{};
+
+    static void bump(std::atomic<long long> &counter) noexcept
+    {
+        Proof::detail::bumpOwnedCounter(counter, std::memory_order_release);
+    }
+
+    static void bump(std::array<std::atomic<long long>, TasksHistogram::BUCKETS_COUNT> &histogram,
+                     std::chrono::steady_clock::duration duration) noexcept
+    {
+        auto usecs = static_cast<unsigned long long>(
+            qMax(0ll, static_cast<long long>(
+                          std::chrono::duration_cast<std::chrono::microseconds>(duration).count())));
+        size_t bucket = 0;
+        while (usecs && bucket < TasksHistogram::BUCKETS_COUNT - 1) {
+            usecs >>= 1;
+            ++bucket;
+        }
+        bump(histogram[bucket]);
+    }
+};
+} // namespace detail
+
+class PROOF_SEED_EXPORT TasksMetrics
+{
+public:
+    TasksMetrics() = delete;
+    TasksMetrics(const TasksMetrics &) = delete;
+    TasksMetrics(TasksMetrics &&) = delete;
+    TasksMetrics &operator=(const TasksMetrics &) = delete;
+    TasksMetrics &operator=(TasksMetrics &&) = delete;
+    ~TasksMetrics() = delete;
+
+    // Disabled by default. Only tasks submitted while metrics are enabled are counted.
+    static void setEnabled(bool enabled) noexcept;
+    static bool isEnabled() noexcept;
+
+    // Aggregates counters of all threads. Counters are never reset, so rates should be calculated
+    // as difference between two snapshots.
+    static QVector<TasksGroupMetrics> snapshot();
+
+    // Returns nullptr if counters can't be allocated, such tasks are not counted
+    static detail::TaskCounters *threadCounters(asynqro::tasks::TaskType type, int32_t tag,
+                                                asynqro::tasks::TaskPriority priority) noexcept;
+};
+
+namespace detail {
+template <typename Task>
+class InstrumentedTask
+{
+public:
+    InstrumentedTask(Task &&task, asynqro::tasks::TaskType type, int32_t tag, asynqro::tasks::TaskPriority priority)
+        : m_task(std::move(task)), m_type(type), m_tag(tag), m_priority(priority),
+          m_enqueuedAt(std::chrono::steady_clock::now())
+    {
+        if (TaskCounters *counters = TasksMetrics::threadCounters(m_type, m_tag, m_priority))
+            TaskCounters::bump(counters->enqueued);
+    }
+
+    auto operator()()
+    {
+        TaskCounters *counters = TasksMetrics::threadCounters(m_type, m_tag, m_priority);
+        const auto startedAt = std::chrono::steady_clock::now();
+        if (counters) {
+            TaskCounters::bump(counters->started);
+            TaskCounters::bump(counters->waitTime, startedAt - m_enqueuedAt);
+        }
+        FinishGuard guard{counters, startedAt};
+        return m_task();
+    }
+
+private:
+    struct FinishGuard
+    {
+        TaskCounters *counters;
+        std::chrono::steady_clock::time_point startedAt;
+        ~FinishGuard()
+        {
+            if (!counters)
+                return;
+            TaskCounters::bump(counters->execTime, std::chrono::steady_clock::now() - startedAt);
+            TaskCounters::bump(counters->finished);
+        }
+    };
+
+    Task m_task;
+    asynqro::tasks::TaskType m_type;
+    int32_t m_tag;
+    asynqro::tasks::TaskPriority m_priority;
+    std::chrono::steady_clock::time_point m_enqueuedAt;
+};
+
+// Same defaults as in asynqro::tasks::run
+template <typename Task>
+auto instrumentTask(Task &&task, asynqro::tasks::TaskType type = asynqro::tasks::TaskType::Intensive,
+                    int32_t tag = 0, asynqro::tasks::TaskPriority priority = asynqro::tasks::TaskPriority::Regular)
+{
+    return InstrumentedTask<std::decay_t<Task>>(std::decay_t<Task>(std::forward<Task>(task)), type, tag, priority);
+}
+} // namespace detail
+} // namespace tasks
+} // namespace Proof
+
+#endif // PROOFSEED_TASKSMETRICS_H
@@ -0,0 +1,187 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_UNIQUEFUNCTION_H
+#define PROOFSEED_UNIQUEFUNCTION_H
+
+#include "proofseed/memorypool.h"
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Proof {
+template <typename Signature>
+class UniqueFunction;
+
+// Move-only replacement for std::function.
+// Callables that fit into INLINE_SIZE bytes and are nothrow movable are stored in place, bigger ones go to MemoryPool.
+// Whole object takes exactly one cache line, so it can be embedded into pooled task states without growing them.
+template <typename R, typename... Args>
+class UniqueFunction<R(Args...)>
+{
+public:
+    static constexpr size_t INLINE_SIZE = 64 - sizeof(void *);
+
+    template <typename Callable>
+    static constexpr bool isStoredInline = sizeof(Callable) <= INLINE_SIZE
+                                           && alignof(Callable) <= alignof(std::max_align_t)
+                                           && std::is_nothrow_move_constructible_v<Callable>;
+
+    UniqueFunction() noexcept = default;
+    UniqueFunction(std::nullptr_t) noexcept {} // NOLINT(google-explicit-constructor)
+    template <typename F, typename Callable = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same_v<Callable, UniqueFunction>
+                                          && std::is_invocable_r_v<R, Callable &, Args...>>>
+    UniqueFunction(F &&f) // NOLINT(google-explicit-constructor)
+    {
+        if constexpr (std::is_pointer_v<Callable> || std::is_member_pointer_v<Callable>
+                      || std::is_same_v<Callable, std::function<R(Args...)>>) {
+            if (!f)
+                return;
+        }
+        if constexpr (isStoredInline<Callable>) {
+            new (m_storage) Callable(std::forward<F>(f));
+            m_ops = &InlineOps<Callable>::ops;
+        } else {
+            PoolAllocator<Callable> allocator;
+            Callable *callable = allocator.allocate(1);
+            try {
+                new (callable) Callable(std::forward<F>(f));
+            } catch (...) {
+                allocator.deallocate(callable, 1);
+                throw;
+            }
+            new (m_storage) Callable *(callable);
+            m_ops = &HeapOps<Callable>::ops;
+        }
+    }
+    UniqueFunction(const UniqueFunction &) = delete;
+    UniqueFunction(UniqueFunction &&other) noexcept { moveFrom(other); }
+    UniqueFunction &operator=(const UniqueFunction &) = delete;
+    UniqueFunction &operator=(UniqueFunction &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+    UniqueFunction &operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+    ~UniqueFunction() { reset(); }
+
+    explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+    // Same as std::function it is callable through const reference, constness is not propagated to callable
+    R operator()(Args... args) const
+    {
+        if (!m_ops)
+            throw std::bad_function_call();
+        return m_ops->invoke(const_cast<unsigned char *>(m_storage), std::forward<Args>(args)...);
+    }
+
+private:
+    struct Ops
+    {
+        R (*invoke)(void *, Args &&...);
+        // Move constructs into destination and destroys source
+        void (*relocate)(void *, void *) noexcept;
+        void (*destroy)(void *) noexcept;
+    };
+
+    template <typename Callable>
+    static R invokeCallable(Callable &callable, Args &&... args)
+    {
+        if constexpr (std::is_void_v<R>)
+            std::invoke(callable, std::forward<Args>(args)...);
+        else
+            return std::invoke(callable, std::forward<Args>(args)...);
+    }
+
+    template <typename Callable>
+    struct InlineOps
+    {
+        static R invoke(void *storage, Args &&... args)
+        {
+            return invokeCallable(*std::launder(static_cast<Callable *>(storage)), std::forward<Args>(args)...);
+        }
+        static void relocate(void *from, void *to) noexcept
+        {
+            Callable *source = std::launder(static_cast<Callable *>(from));
+            new (to) Callable(std::move(*source));
+            source->~Callable();
+        }
+        static void destroy(void *storage) noexcept { std::launder(static_cast<Callable *>(storage))->~Callable(); }
+        static constexpr Ops ops = {&invoke, &relocate, &destroy};
+    };
+
+    template <typename Callable>
+    struct HeapOps
+    {
+        static Callable *&callable(void *storage) noexcept { return *std::launder(static_cast<Callable **>(storage)); }
+        static R invoke(void *storage, Args &&... args)
+        {
+            return invokeCallable(*callable(storage), std::forward<Args>(args)...);
+        }
+        static void relocate(void *from, void *to) noexcept { new (to) Callable *(callable(from)); }
+        static void destroy(void *storage) noexcept
+        {
+            Callable *object = callable(storage);
+            object->~Callable();
+            PoolAllocator<Callable>().deallocate(object, 1);
+        }
+        static constexpr Ops ops = {&invoke, &relocate, &destroy};
+    };
+
+    void moveFrom(UniqueFunction &other) noexcept
+    {
+        if (!other.m_ops)
+            return;
+        other.m_ops->relocate(other.m_storage, m_storage);
+        m_ops = other.m_ops;
+        other.m_ops = nullptr;
+    }
+
+    void reset() noexcept
+    {
+        if (!m_ops)
+            return;
+        m_ops->destroy(m_storage);
+        m_ops = nullptr;
+    }
+
+    alignas(std::max_align_t) unsigned char m_storage[INLINE_SIZE];
+    const Ops *m_ops = nullptr;
+};
+} // namespace Proof
+
+#endif // PROOFSEED_UNIQUEFUNCTION_H
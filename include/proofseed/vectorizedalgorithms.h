@@ -0,0 +1,260 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_VECTORIZEDALGORITHMS_H
+#define PROOFSEED_VECTORIZEDALGORITHMS_H
+
+#include "proofseed/proofalgorithms.h"
+#include "proofseed/proofseed_global.h"
+
+#include <type_traits>
+
+namespace Proof {
+namespace algorithms {
+// Operation objects that can be used with any algorithm. If they are passed to reduce, map, filter or exists
+// with contiguous container (QVector, std::vector) of float, double or int,
+// SIMD kernel (AVX2 if cpu supports it, SSE2 otherwise) is used instead of generic loop.
+// Other arithmetic types (including qint64 and unsigned ones) go to generic algorithms.
+// Vectorized reduce accumulates in several lanes, so floating point rounding can differ from sequential version.
+// Integer sum and Scale wrap around on overflow. Results for NaN elements are unspecified.
+namespace ops {
+struct Plus
+{
+    template <typename Acc, typename T>
+    auto operator()(const Acc &acc, const T &x) const
+    {
+        return acc + x;
+    }
+};
+
+struct Min
+{
+    template <typename Acc, typename T>
+    auto operator()(const Acc &acc, const T &x) const
+    {
+        return x < acc ? x : acc;
+    }
+};
+
+struct Max
+{
+    template <typename Acc, typename T>
+    auto operator()(const Acc &acc, const T &x) const
+    {
+        return acc < x ? x : acc;
+    }
+};
+
+// x * factor + offset
+template <typename T>
+struct Scale
+{
+    T factor;
+    T offset = T();
+    T operator()(const T &x) const { return x * factor + offset; }
+};
+
+template <typename T>
+struct Greater
+{
+    T threshold;
+    bool operator()(const T &x) const { return x > threshold; }
+};
+
+template <typename T>
+struct GreaterOrEqual
+{
+    T threshold;
+    bool operator()(const T &x) const { return x >= threshold; }
+};
+
+template <typename T>
+struct Less
+{
+    T threshold;
+    bool operator()(const T &x) const { return x < threshold; }
+};
+
+template <typename T>
+struct LessOrEqual
+{
+    T threshold;
+    bool operator()(const T &x) const { return x <= threshold; }
+};
+} // namespace ops
+
+namespace detail {
+enum class VectorizedComparison
+{
+    Greater,
+    GreaterOrEqual,
+    Less,
+    LessOrEqual
+};
+
+PROOF_SEED_EXPORT float vectorizedSum(const float *data, long long size) noexcept;
+PROOF_SEED_EXPORT double vectorizedSum(const double *data, long long size) noexcept;
+PROOF_SEED_EXPORT int vectorizedSum(const int *data, long long size) noexcept;
+// size should be positive
+PROOF_SEED_EXPORT float vectorizedMin(const float *data, long long size) noexcept;
+PROOF_SEED_EXPORT double vectorizedMin(const double *data, long long size) noexcept;
+PROOF_SEED_EXPORT int vectorizedMin(const int *data, long long size) noexcept;
+PROOF_SEED_EXPORT float vectorizedMax(const float *data, long long size) noexcept;
+PROOF_SEED_EXPORT double vectorizedMax(const double *data, long long size) noexcept;
+PROOF_SEED_EXPORT int vectorizedMax(const int *data, long long size) noexcept;
+PROOF_SEED_EXPORT void vectorizedScale(const float *data, float *destination, long long size, float factor,
+                                       float offset) noexcept;
+PROOF_SEED_EXPORT void vectorizedScale(const double *data, double *destination, long long size, double factor,
+                                       double offset) noexcept;
+PROOF_SEED_EXPORT void vectorizedScale(const int *data, int *destination, long long size, int factor,
+                                       int offset) noexcept;
+// Returns amount of elements copied to destination
+PROOF_SEED_EXPORT long long vectorizedFilter(const float *data, float *destination, long long size,
+                                             VectorizedComparison comparison, float threshold) noexcept;
+PROOF_SEED_EXPORT long long vectorizedFilter(const double *data, double *destination, long long size,
+                                             VectorizedComparison comparison, double threshold) noexcept;
+PROOF_SEED_EXPORT long long vectorizedFilter(const int *data, int *destination, long long size,
+                                             VectorizedComparison comparison, int threshold) noexcept;
+PROOF_SEED_EXPORT bool vectorizedExists(const float *data, long long size, VectorizedComparison comparison,
+                                        float threshold) noexcept;
+PROOF_SEED_EXPORT bool vectorizedExists(const double *data, long long size, VectorizedComparison comparison,
+                                        double threshold) noexcept;
+PROOF_SEED_EXPORT bool vectorizedExists(const int *data, long long size, VectorizedComparison comparison,
+                                        int threshold) noexcept;
+
+template <typename Op>
+struct ComparisonOf;
+
+template <typename T>
+struct ComparisonOf<ops::Greater<T>> : std::integral_constant<VectorizedComparison, VectorizedComparison::Greater>
+{};
+
+template <typename T>
+struct ComparisonOf<ops::GreaterOrEqual<T>>
+    : std::integral_constant<VectorizedComparison, VectorizedComparison::GreaterOrEqual>
+{};
+
+template <typename T>
+struct ComparisonOf<ops::Less<T>> : std::integral_constant<VectorizedComparison, VectorizedComparison::Less>
+{};
+
+template <typename T>
+struct ComparisonOf<ops::LessOrEqual<T>> : std::integral_constant<VectorizedComparison, VectorizedComparison::LessOrEqual>
+{};
+
+template <typename Container, typename T, typename = void>
+struct IsVectorizable : std::false_type
+{};
+
+template <typename Container, typename T>
+struct IsVectorizable<Container, T, std::enable_if_t<std::is_same<decltype(std::declval<const Container &>().data()), const T *>::value>>
+    : std::integral_constant<bool, std::is_same<T, float>::value || std::is_same<T, double>::value
+                                       || std::is_same<T, int>::value>
+{};
+
+template <typename Container, typename T>
+constexpr bool IsVectorizable_V = IsVectorizable<Container, T>::value;
+
+template <typename Container, typename T, typename Op>
+Container vectorizedFilter(const Container &container, const Op &op)
+{
+    const long long size = static_cast<long long>(container.size());
+    Container result;
+    result.resize(static_cast<decltype(result.size())>(size));
+    const long long count = vectorizedFilter(container.data(), result.data(), size, ComparisonOf<Op>::value,
+                                             op.threshold);
+    result.resize(static_cast<decltype(result.size())>(count));
+    return result;
+}
+} // namespace detail
+
+template <typename Container, typename T, typename = std::enable_if_t<detail::IsVectorizable_V<Container, T>>>
+T reduce(const Container &container, ops::Plus, T acc)
+{
+    return acc + detail::vectorizedSum(container.data(), static_cast<long long>(container.size()));
+}
+
+template <typename Container, typename T, typename = std::enable_if_t<detail::IsVectorizable_V<Container, T>>>
+T reduce(const Container &container, ops::Min op, T acc)
+{
+    const long long size = static_cast<long long>(container.size());
+    return size ? op(acc, detail::vectorizedMin(container.data(), size)) : acc;
+}
+
+template <typename Container, typename T, typename = std::enable_if_t<detail::IsVectorizable_V<Container, T>>>
+T reduce(const Container &container, ops::Max op, T acc)
+{
+    const long long size = static_cast<long long>(container.size());
+    return size ? op(acc, detail::vectorizedMax(container.data(), size)) : acc;
+}
+
+template <template <typename...> class Container, typename T, typename... Args,
+          typename = std::enable_if_t<detail::IsVectorizable_V<Container<T, Args...>, T>>>
+Container<T, Args...> map(const Container<T, Args...> &container, ops::Scale<T> op)
+{
+    const long long size = static_cast<long long>(container.size());
+    Container<T, Args...> result;
+    result.resize(static_cast<decltype(result.size())>(size));
+    detail::vectorizedScale(container.data(), result.data(), size, op.factor, op.offset);
+    return result;
+}
+
+template <typename Container, typename T, typename = std::enable_if_t<detail::IsVectorizable_V<Container, T>>>
+Container filter(const Container &container, ops::Greater<T> op)
+{
+    return detail::vectorizedFilter<Container, T>(container, op);
+}
+
+template <typename Container, typename T, typename = std::enable_if_t<detail::IsVectorizable_V<Container, T>>>
+Container filter(const Container &container, ops::GreaterOrEqual<T> op)
+{
+    return detail::vectorizedFilter<Container, T>(container, op);
+}
+
+template <typename Container, typename T, typename = std::enable_if_t<detail::IsVectorizable_V<Container, T>>>
+Container filter(const Container &container, ops::Less<T> op)
+{
+    return detail::vectorizedFilter<Container, T>(container, op);
+}
+
+template <typename Container, typename T, typename = std::enable_if_t<detail::IsVectorizable_V<Container, T>>>
+Container filter(const Container &container, ops::LessOrEqual<T> op)
+{
+    return detail::vectorizedFilter<Container, T>(container, op);
+}
+
+template <typename Container, typename T, template <typename> class Op,
+          typename = std::enable_if_t<detail::IsVectorizable_V<Container, T>>,
+          typename = decltype(detail::ComparisonOf<Op<T>>::value)>
+bool exists(const Container &container, Op<T> op)
+{
+    return detail::vectorizedExists(container.data(), static_cast<long long>(container.size()),
+                                    detail::ComparisonOf<Op<T>>::value, op.threshold);
+}
+} // namespace algorithms
+} // namespace Proof
+
+#endif // PROOFSEED_VECTORIZEDALGORITHMS_H
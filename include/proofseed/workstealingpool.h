@@ -0,0 +1,99 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_WORKSTEALINGPOOL_H
+#define PROOFSEED_WORKSTEALINGPOOL_H
+
+#include "proofseed/proofseed_global.h"
+#include "proofseed/uniquefunction.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Proof {
+namespace tasks {
+enum class Scheduling
+{
+    // Intensive tasks go through asynqro TaskRunner
+    SharedQueue,
+    // Intensive tasks with regular priority and no tag from tasks::run, runAndForget and clusteredRun
+    // go to WorkStealingPool, asynqro Intensive pool gets only prioritized ones
+    WorkStealing
+};
+
+// Pool of threads with own Chase-Lev deque per worker. Tasks posted from worker thread go to its deque
+// and are taken back in LIFO order, idle workers steal from other deques in FIFO order.
+// Tasks posted from other threads are spread over several injection queues, one per worker.
+class PROOF_SEED_EXPORT WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(qint32 capacity);
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool(WorkStealingPool &&) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(WorkStealingPool &&) = delete;
+    // Tasks not started yet are dropped
+    ~WorkStealingPool();
+
+    // Global pool, created on first use with same amount of workers as asynqro Intensive pool has.
+    // Workers of both pools are busy at once only if prioritized Intensive tasks are mixed with stolen ones
+    static WorkStealingPool *instance();
+
+    // Process wide switch, SharedQueue by default. Tasks posted before the switch stay where they were posted
+    static void setScheduling(Scheduling scheduling) noexcept;
+    static Scheduling scheduling() noexcept;
+
+    qint32 capacity() const noexcept;
+    bool isWorkerThread() const noexcept;
+    // Exceptions thrown by task are ignored, same as in tasks::runAndForget
+    void post(UniqueFunction<void()> &&task) noexcept;
+
+private:
+    struct Task;
+    struct Worker;
+    struct InjectionQueue;
+
+    void workerLoop(size_t index);
+    Task *findTask(size_t index);
+    bool hasVisibleTasks() const;
+    void wakeOne();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::unique_ptr<InjectionQueue>> m_injectionQueues;
+
+    std::atomic_bool m_stopping{false};
+    std::mutex m_sleepLock;
+    std::condition_variable m_sleepCondition;
+    std::atomic<qint32> m_sleepers{0};
+    qint32 m_wakeups = 0;
+};
+} // namespace tasks
+} // namespace Proof
+
+#endif // PROOFSEED_WORKSTEALINGPOOL_H
@@ -27,7 +27,19 @@
 
 // Dummy file with including headers due to lack of including them in other TUs in this module
 
+#include "proofseed/algorithmviews.h"
 #include "proofseed/asynqro_extra.h"
+#include "proofseed/boundedqueue.h"
+#include "proofseed/coroutines.h"
+#include "proofseed/flathash.h"
+#include "proofseed/memorypool.h"
+#include "proofseed/parallelalgorithms.h"
+#include "proofseed/pipeline.h"
 #include "proofseed/planting.h"
 #include "proofseed/proofalgorithms.h"
+#include "proofseed/readyfuture.h"
 #include "proofseed/tasks.h"
+#include "proofseed/tasksmetrics.h"
+#include "proofseed/uniquefunction.h"
+#include "proofseed/vectorizedalgorithms.h"
+#include "proofseed/workstealingpool.h"
@@ -0,0 +1,307 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#include "proofseed/memorypool.h"
+
+#include "proofseed/asynqro_extra.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+using namespace Proof;
+
+namespace {
+constexpr size_t MIN_BLOCK_SIZE = 16;
+constexpr size_t CLASSES_COUNT = 6;
+constexpr size_t SLAB_SIZE = 64 * 1024;
+static_assert(MIN_BLOCK_SIZE << (CLASSES_COUNT - 1) == MemoryPool::MAX_BLOCK_SIZE, "Size classes should cover all blocks");
+static_assert(MIN_BLOCK_SIZE % alignof(std::max_align_t) == 0, "Blocks should be aligned as global heap ones");
+
+size_t sizeClassOf(size_t size)
+{
+    size_t result = 0;
+    for (size_t block = MIN_BLOCK_SIZE; block < size; block <<= 1)
+        ++result;
+    return result;
+}
+
+size_t blockSize(size_t sizeClass)
+{
+    return MIN_BLOCK_SIZE << sizeClass;
+}
+
+// Amount of blocks moved between thread local and shared free lists at once
+size_t batchSize(size_t sizeClass)
+{
+    return std::max<size_t>(8, 4096 / blockSize(sizeClass));
+}
+
+struct FreeBlock
+{
+    FreeBlock *next;
+};
+
+struct SharedFreeList
+{
+    SpinLock lock;
+    FreeBlock *head = nullptr;
+};
+
+// Only owner thread writes to them, they are incremented with detail::bumpOwnedCounter
+struct PoolCounters
+{
+    std::atomic<quint64> hits{0};
+    std::atomic<quint64> misses{0};
+    std::atomic<quint64> oversized{0};
+};
+
+class ThreadCache;
+
+struct PoolRegistry
+{
+    std::array<SharedFreeList, CLASSES_COUNT> freeLists;
+    std::atomic<quint64> reservedBytes{0};
+
+    std::mutex lock;
+    std::vector<ThreadCache *> threads;
+    // Counters of already finished threads and of allocations made after thread cache destruction
+    std::atomic<quint64> retiredHits{0};
+    std::atomic<quint64> retiredMisses{0};
+    std::atomic<quint64> retiredOversized{0};
+};
+
+PoolRegistry *registry()
+{
+    // Intentionally leaked, pooled objects can outlive static objects
+    static auto *result = new PoolRegistry;
+    return result;
+}
+
+void pushShared(size_t sizeClass, FreeBlock *first, FreeBlock *last) noexcept
+{
+    SharedFreeList &list = registry()->freeLists[sizeClass];
+    SpinLockHolder holder(&list.lock);
+    last->next = list.head;
+    list.head = first;
+}
+
+// Only first batch of blocks of new slab is returned, all others go to shared list
+FreeBlock *carveSlab(size_t sizeClass)
+{
+    const size_t size = blockSize(sizeClass);
+    const size_t count = SLAB_SIZE / size;
+    const size_t batch = batchSize(sizeClass);
+    auto *slab = static_cast<char *>(::operator new(SLAB_SIZE));
+    registry()->reservedBytes.fetch_add(SLAB_SIZE, std::memory_order_relaxed);
+    auto blockAt = [slab, size](size_t index) { return reinterpret_cast<FreeBlock *>(slab + index * size); };
+    for (size_t i = 0; i + 1 < count; ++i)
+        blockAt(i)->next = blockAt(i + 1);
+    blockAt(count - 1)->next = nullptr;
+    if (count > batch) {
+        blockAt(batch - 1)->next = nullptr;
+        pushShared(sizeClass, blockAt(batch), blockAt(count - 1));
+    }
+    return blockAt(0);
+}
+
+// Detaches up to batchSize blocks from shared list
+FreeBlock *popShared(size_t sizeClass) noexcept
+{
+    SharedFreeList &list = registry()->freeLists[sizeClass];
+    SpinLockHolder holder(&list.lock);
+    FreeBlock *first = list.head;
+    if (!first)
+        return nullptr;
+    FreeBlock *last = first;
+    for (size_t i = batchSize(sizeClass); i > 1 && last->next; --i)
+        last = last->next;
+    list.head = last->next;
+    last->next = nullptr;
+    return first;
+}
+
+thread_local bool threadCacheDestroyed = false;
+
+class ThreadCache
+{
+public:
+    ThreadCache()
+    {
+        PoolRegistry *global = registry();
+        std::lock_guard<std::mutex> lock(global->lock);
+        global->threads.push_back(this);
+    }
+    ThreadCache(const ThreadCache &) = delete;
+    ThreadCache(ThreadCache &&) = delete;
+    ThreadCache &operator=(const ThreadCache &) = delete;
+    ThreadCache &operator=(ThreadCache &&) = delete;
+
+    ~ThreadCache()
+    {
+        // Objects freed by other thread local destructors after this point go directly to shared lists
+        threadCacheDestroyed = true;
+        for (size_t i = 0; i < CLASSES_COUNT; ++i) {
+            FreeBlock *first = m_heads[i];
+            if (!first)
+                continue;
+            FreeBlock *last = first;
+            while (last->next)
+                last = last->next;
+            pushShared(i, first, last);
+        }
+        PoolRegistry *global = registry();
+        std::lock_guard<std::mutex> lock(global->lock);
+        global->threads.erase(std::remove(global->threads.begin(), global->threads.end(), this), global->threads.end());
+        global->retiredHits += m_counters.hits.load(std::memory_order_relaxed);
+        global->retiredMisses += m_counters.misses.load(std::memory_order_relaxed);
+        global->retiredOversized += m_counters.oversized.load(std::memory_order_relaxed);
+    }
+
+    void *allocate(size_t sizeClass)
+    {
+        FreeBlock *block = m_heads[sizeClass];
+        if (block) {
+            detail::bumpOwnedCounter(m_counters.hits);
+        } else {
+            detail::bumpOwnedCounter(m_counters.misses);
+            block = popShared(sizeClass);
+            if (!block)
+                block = carveSlab(sizeClass);
+            m_counts[sizeClass] = 1;
+            for (FreeBlock *it = block->next; it; it = it->next)
+                ++m_counts[sizeClass];
+        }
+        m_heads[sizeClass] = block->next;
+        --m_counts[sizeClass];
+        return block;
+    }
+
+    void deallocate(void *ptr, size_t sizeClass) noexcept
+    {
+        auto *block = static_cast<FreeBlock *>(ptr);
+        block->next = m_heads[sizeClass];
+        m_heads[sizeClass] = block;
+        // Threads that mostly free blocks allocated by others give them back to shared lists.
+        // Recently freed blocks are kept, they are more likely to be in cpu cache.
+        const size_t batch = batchSize(sizeClass);
+        if (++m_counts[sizeClass] < 2 * batch)
+            return;
+        FreeBlock *kept = block;
+        for (size_t i = 1; i < batch; ++i)
+            kept = kept->next;
+        FreeBlock *first = kept->next;
+        FreeBlock *last = first;
+        for (size_t i = 1; i < batch; ++i)
+            last = last->next;
+        kept->next = last->next;
+        m_counts[sizeClass] -= batch;
+        pushShared(sizeClass, first, last);
+    }
+
+    void countOversized() noexcept { detail::bumpOwnedCounter(m_counters.oversized); }
+
+    void collect(MemoryPoolStats &stats) const noexcept
+    {
+        stats.hits += m_counters.hits.load(std::memory_order_relaxed);
+        stats.misses += m_counters.misses.load(std::memory_order_relaxed);
+        stats.oversized += m_counters.oversized.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::array<FreeBlock *, CLASSES_COUNT> m_heads{};
+    std::array<size_t, CLASSES_COUNT> m_counts{};
+    PoolCounters m_counters;
+};
+
+ThreadCache *threadCache() noexcept
+{
+    if (threadCacheDestroyed)
+        return nullptr;
+    thread_local ThreadCache cache;
+    return &cache;
+}
+} // namespace
+
+void *MemoryPool::allocate(size_t size)
+{
+    ThreadCache *cache = threadCache();
+    if (size > MAX_BLOCK_SIZE) {
+        if (cache)
+            cache->countOversized();
+        else
+            registry()->retiredOversized.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+    const size_t sizeClass = sizeClassOf(size);
+    if (cache)
+        return cache->allocate(sizeClass);
+
+    registry()->retiredMisses.fetch_add(1, std::memory_order_relaxed);
+    FreeBlock *block = popShared(sizeClass);
+    if (!block)
+        block = carveSlab(sizeClass);
+    if (FreeBlock *rest = block->next) {
+        FreeBlock *last = rest;
+        while (last->next)
+            last = last->next;
+        pushShared(sizeClass, rest, last);
+    }
+    return block;
+}
+
+void MemoryPool::deallocate(void *ptr, size_t size) noexcept
+{
+    if (!ptr)
+        return;
+    if (size > MAX_BLOCK_SIZE) {
+        ::operator delete(ptr);
+        return;
+    }
+    const size_t sizeClass = sizeClassOf(size);
+    if (ThreadCache *cache = threadCache()) {
+        cache->deallocate(ptr, sizeClass);
+    } else {
+        auto *block = static_cast<FreeBlock *>(ptr);
+        pushShared(sizeClass, block, block);
+    }
+}
+
+MemoryPoolStats MemoryPool::stats() noexcept
+{
+    MemoryPoolStats result;
+    PoolRegistry *global = registry();
+    std::lock_guard<std::mutex> lock(global->lock);
+    for (ThreadCache *thread : global->threads)
+        thread->collect(result);
+    result.hits += global->retiredHits.load(std::memory_order_relaxed);
+    result.misses += global->retiredMisses.load(std::memory_order_relaxed);
+    result.oversized += global->retiredOversized.load(std::memory_order_relaxed);
+    result.reservedBytes = global->reservedBytes.load(std::memory_order_relaxed);
+    return result;
+}
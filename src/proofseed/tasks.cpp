@@ -28,14 +28,46 @@
 
 #include <QCoreApplication>
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace Proof {
 namespace tasks {
 static thread_local bool currentEventLoopStarted = false;
 static thread_local QSharedPointer<QEventLoop> signalWaitersEventLoop{};
+static thread_local QVector<QSharedPointer<detail::SignalWaiterBase>> currentEventLoopWaiters{};
+
+namespace {
+struct SignalWaitersRegistryData
+{
+    std::mutex mutex;
+    std::unordered_map<QObject *, std::vector<QSharedPointer<detail::SignalMultiplexerBase>>> multiplexers;
+    qint64 multiplexersCount = 0;
+};
+
+SignalWaitersRegistryData &registryData()
+{
+    // Intentionally leaked, waiters can be removed during static destruction
+    static auto *data = new SignalWaitersRegistryData;
+    return *data;
+}
+
+void releaseCurrentEventLoopWaiters() noexcept
+{
+    auto waiters = std::move(currentEventLoopWaiters);
+    currentEventLoopWaiters = QVector<QSharedPointer<detail::SignalWaiterBase>>();
+    for (const auto &waiter : waiters) {
+        if (waiter->markDone())
+            detail::SignalWaitersRegistry::removeWaiter(waiter.data());
+    }
+}
+} // namespace
 } // namespace tasks
 } // namespace Proof
 
 using namespace Proof::tasks;
+using namespace Proof::tasks::detail;
 
 void TasksExtra::fireSignalWaiters() noexcept
 {
@@ -47,16 +79,27 @@ void TasksExtra::fireSignalWaiters() noexcept
     clearEventLoop();
 }
 
-void TasksExtra::addSignalWaiterPrivate(std::function<void(const QSharedPointer<QEventLoop> &)> &&connector) noexcept
+QSharedPointer<QEventLoop> TasksExtra::currentSignalWaitersEventLoop()
 {
-    try {
-        if (!signalWaitersEventLoop) {
-            currentEventLoopStarted = false;
-            signalWaitersEventLoop.reset(new QEventLoop);
-        }
-        connector(signalWaitersEventLoop);
-    } catch (...) {
+    if (!signalWaitersEventLoop) {
+        currentEventLoopStarted = false;
+        signalWaitersEventLoop.reset(new QEventLoop);
     }
+    return signalWaitersEventLoop;
+}
+
+void TasksExtra::trackSignalWaiter(const QSharedPointer<SignalWaiterBase> &waiter)
+{
+    currentEventLoopWaiters << waiter;
+}
+
+void TasksExtra::signalWaiterSatisfied() noexcept
+{
+    releaseCurrentEventLoopWaiters();
+    if (!eventLoopStarted())
+        clearEventLoop();
+    else if (signalWaitersEventLoop)
+        signalWaitersEventLoop->quit();
 }
 
 bool TasksExtra::eventLoopStarted() noexcept
@@ -66,6 +109,108 @@ bool TasksExtra::eventLoopStarted() noexcept
 
 void TasksExtra::clearEventLoop() noexcept
 {
+    releaseCurrentEventLoopWaiters();
     signalWaitersEventLoop.clear();
     currentEventLoopStarted = false;
 }
+
+void SignalWaitersRegistry::addWaiter(QObject *sender, int signalIndex, std::type_index argsType,
+                                      const QSharedPointer<SignalWaiterBase> &waiter,
+                                      const UniqueFunction<QSharedPointer<SignalMultiplexerBase>()> &multiplexerCreator)
+{
+    auto &data = registryData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    QSharedPointer<SignalMultiplexerBase> multiplexer;
+    auto senderIt = data.multiplexers.find(sender);
+    if (senderIt != data.multiplexers.end()) {
+        auto it = std::find_if(senderIt->second.cbegin(), senderIt->second.cend(), [signalIndex, argsType](const auto &x) {
+            return x->m_signalIndex == signalIndex && x->m_argsType == argsType;
+        });
+        if (it != senderIt->second.cend())
+            multiplexer = *it;
+    }
+    if (!multiplexer) {
+        multiplexer = multiplexerCreator();
+        data.multiplexers[sender].push_back(multiplexer);
+        ++data.multiplexersCount;
+    }
+    SpinLockHolder waitersLock(&multiplexer->m_waitersLock);
+    waiter->m_position = multiplexer->m_waiters.insert(multiplexer->m_waiters.end(), waiter);
+    waiter->m_multiplexer = multiplexer.data();
+}
+
+void SignalWaitersRegistry::removeWaiter(SignalWaiterBase *waiter) noexcept
+{
+    // Both are released after registry is unlocked
+    QSharedPointer<SignalWaiterBase> removedWaiter;
+    QSharedPointer<SignalMultiplexerBase> removedMultiplexer;
+    auto &data = registryData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    SignalMultiplexerBase *multiplexer = waiter->m_multiplexer;
+    if (!multiplexer)
+        return;
+    waiter->m_multiplexer = nullptr;
+    bool multiplexerIsEmpty = false;
+    {
+        SpinLockHolder waitersLock(&multiplexer->m_waitersLock);
+        removedWaiter = *waiter->m_position;
+        multiplexer->m_waiters.erase(waiter->m_position);
+        multiplexerIsEmpty = multiplexer->m_waiters.empty();
+    }
+    if (!multiplexerIsEmpty)
+        return;
+
+    QObject::disconnect(multiplexer->m_signalConnection);
+    QObject::disconnect(multiplexer->m_destroyedConnection);
+    auto senderIt = data.multiplexers.find(multiplexer->m_sender);
+    if (senderIt == data.multiplexers.end())
+        return;
+    auto &senderMultiplexers = senderIt->second;
+    auto it = std::find_if(senderMultiplexers.begin(), senderMultiplexers.end(),
+                           [multiplexer](const auto &x) { return x.data() == multiplexer; });
+    if (it == senderMultiplexers.end())
+        return;
+    removedMultiplexer = *it;
+    senderMultiplexers.erase(it);
+    if (senderMultiplexers.empty())
+        data.multiplexers.erase(senderIt);
+    --data.multiplexersCount;
+}
+
+void SignalWaitersRegistry::senderDestroyed(SignalMultiplexerBase *multiplexer) noexcept
+{
+    std::list<QSharedPointer<SignalWaiterBase>> waiters;
+    QSharedPointer<SignalMultiplexerBase> removedMultiplexer;
+    {
+        auto &data = registryData();
+        std::lock_guard<std::mutex> lock(data.mutex);
+        auto senderIt = data.multiplexers.find(multiplexer->m_sender);
+        if (senderIt == data.multiplexers.end())
+            return;
+        auto &senderMultiplexers = senderIt->second;
+        auto it = std::find_if(senderMultiplexers.begin(), senderMultiplexers.end(),
+                               [multiplexer](const auto &x) { return x.data() == multiplexer; });
+        if (it == senderMultiplexers.end())
+            return;
+        removedMultiplexer = *it;
+        senderMultiplexers.erase(it);
+        if (senderMultiplexers.empty())
+            data.multiplexers.erase(senderIt);
+        --data.multiplexersCount;
+        {
+            SpinLockHolder waitersLock(&multiplexer->m_waitersLock);
+            waiters.swap(multiplexer->m_waiters);
+        }
+        for (const auto &waiter : waiters)
+            waiter->m_multiplexer = nullptr;
+    }
+    for (const auto &waiter : waiters)
+        waiter->senderDestroyed();
+}
+
+qint64 SignalWaitersRegistry::multiplexersCount() noexcept
+{
+    auto &data = registryData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    return data.multiplexersCount;
+}
@@ -0,0 +1,206 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#include "proofseed/tasksmetrics.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace Proof::tasks;
+using Proof::tasks::detail::TaskCounters;
+using asynqro::tasks::TaskPriority;
+using asynqro::tasks::TaskType;
+
+namespace {
+using Histogram = std::array<long long, TasksHistogram::BUCKETS_COUNT>;
+
+struct RawMetrics
+{
+    long long enqueued = 0;
+    long long started = 0;
+    long long finished = 0;
+    Histogram waitTime{};
+    Histogram execTime{};
+
+    void add(const TaskCounters &counters)
+    {
+        enqueued += counters.enqueued.load(std::memory_order_acquire);
+        started += counters.started.load(std::memory_order_acquire);
+        finished += counters.finished.load(std::memory_order_acquire);
+        for (size_t i = 0; i < waitTime.size(); ++i) {
+            waitTime[i] += counters.waitTime[i].load(std::memory_order_acquire);
+            execTime[i] += counters.execTime[i].load(std::memory_order_acquire);
+        }
+    }
+
+    void add(const RawMetrics &other)
+    {
+        enqueued += other.enqueued;
+        started += other.started;
+        finished += other.finished;
+        for (size_t i = 0; i < waitTime.size(); ++i) {
+            waitTime[i] += other.waitTime[i];
+            execTime[i] += other.execTime[i];
+        }
+    }
+};
+
+quint64 metricsKey(TaskType type, int32_t tag, TaskPriority priority)
+{
+    return (static_cast<quint64>(type) << 40) | (static_cast<quint64>(priority) << 32) | static_cast<quint32>(tag);
+}
+
+class ThreadMetrics;
+
+struct MetricsRegistry
+{
+    std::mutex lock;
+    std::vector<ThreadMetrics *> threads;
+    // Counters of already finished threads
+    std::unordered_map<quint64, RawMetrics> retired;
+};
+
+MetricsRegistry *registry()
+{
+    // Intentionally leaked, thread local counters can outlive static objects
+    static auto *result = new MetricsRegistry;
+    return result;
+}
+
+std::atomic_bool metricsEnabled{false};
+
+class ThreadMetrics
+{
+public:
+    ThreadMetrics()
+    {
+        MetricsRegistry *global = registry();
+        std::lock_guard<std::mutex> lock(global->lock);
+        global->threads.push_back(this);
+    }
+    ThreadMetrics(const ThreadMetrics &) = delete;
+    ThreadMetrics(ThreadMetrics &&) = delete;
+    ThreadMetrics &operator=(const ThreadMetrics &) = delete;
+    ThreadMetrics &operator=(ThreadMetrics &&) = delete;
+
+    ~ThreadMetrics()
+    {
+        MetricsRegistry *global = registry();
+        std::lock_guard<std::mutex> lock(global->lock);
+        global->threads.erase(std::remove(global->threads.begin(), global->threads.end(), this),
+                              global->threads.end());
+        for (const auto &counters : m_counters)
+            global->retired[counters.first].add(*counters.second);
+    }
+
+    TaskCounters *counters(quint64 key)
+    {
+        // Most of the threads use the same few groups in row, so last one is cached
+        if (m_lastCounters && m_lastKey == key)
+            return m_lastCounters;
+        auto it = m_counters.find(key);
+        if (it == m_counters.end()) {
+            // Metrics are best effort, task is still executed if there is no memory for its counters
+            try {
+                std::lock_guard<std::mutex> lock(m_lock);
+                it = m_counters.emplace(key, std::make_unique<TaskCounters>()).first;
+            } catch (...) {
+                return nullptr;
+            }
+        }
+        m_lastKey = key;
+        m_lastCounters = it->second.get();
+        return m_lastCounters;
+    }
+
+    void collect(std::unordered_map<quint64, RawMetrics> &result)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (const auto &counters : m_counters)
+            result[counters.first].add(*counters.second);
+    }
+
+private:
+    // Only owner thread modifies map, lock is needed only against concurrent collect()
+    std::mutex m_lock;
+    std::unordered_map<quint64, std::unique_ptr<TaskCounters>> m_counters;
+    quint64 m_lastKey = 0;
+    TaskCounters *m_lastCounters = nullptr;
+};
+
+thread_local ThreadMetrics threadMetrics;
+} // namespace
+
+void TasksMetrics::setEnabled(bool enabled) noexcept
+{
+    metricsEnabled = enabled;
+}
+
+bool TasksMetrics::isEnabled() noexcept
+{
+    return metricsEnabled.load(std::memory_order_acquire);
+}
+
+TaskCounters *TasksMetrics::threadCounters(TaskType type, int32_t tag, TaskPriority priority) noexcept
+{
+    return threadMetrics.counters(metricsKey(type, tag, priority));
+}
+
+QVector<TasksGroupMetrics> TasksMetrics::snapshot()
+{
+    std::unordered_map<quint64, RawMetrics> raw;
+    {
+        MetricsRegistry *global = registry();
+        std::lock_guard<std::mutex> lock(global->lock);
+        for (ThreadMetrics *thread : global->threads)
+            thread->collect(raw);
+        for (const auto &retired : global->retired)
+            raw[retired.first].add(retired.second);
+    }
+
+    QVector<TasksGroupMetrics> result;
+    result.reserve(static_cast<int>(raw.size()));
+    for (const auto &metrics : raw) {
+        TasksGroupMetrics group;
+        group.type = static_cast<TaskType>(metrics.first >> 40);
+        group.priority = static_cast<TaskPriority>((metrics.first >> 32) & 0xFF);
+        group.tag = static_cast<int32_t>(metrics.first & 0xFFFFFFFF);
+        // Counters of different threads are read at slightly different moments
+        group.queued = qMax(0ll, metrics.second.enqueued - metrics.second.started);
+        group.running = qMax(0ll, metrics.second.started - metrics.second.finished);
+        group.finished = metrics.second.finished;
+        group.waitTime.buckets = metrics.second.waitTime;
+        group.execTime.buckets = metrics.second.execTime;
+        result << group;
+    }
+    std::sort(result.begin(), result.end(), [](const TasksGroupMetrics &left, const TasksGroupMetrics &right) {
+        return metricsKey(left.type, left.tag, left.priority) < metricsKey(right.type, right.tag, right.priority);
+    });
+    return result;
+}
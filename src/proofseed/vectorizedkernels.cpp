@@ -0,0 +1,365 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#include "proofseed/vectorizedalgorithms.h"
+
+#include "vectorizedkernels_p.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define PROOF_SEED_SSE2_KERNELS
+#    include <emmintrin.h>
+#endif
+
+#if defined(PROOF_SEED_AVX2_KERNELS) && defined(_MSC_VER)
+#    include <immintrin.h>
+#    include <intrin.h>
+#endif
+
+using namespace Proof::algorithms::detail;
+
+static_assert(static_cast<int>(VectorizedComparison::Greater) == 0
+                  && static_cast<int>(VectorizedComparison::GreaterOrEqual) == 1
+                  && static_cast<int>(VectorizedComparison::Less) == 2
+                  && static_cast<int>(VectorizedComparison::LessOrEqual) == 3,
+              "Comparisons are used as indices in kernels table");
+
+namespace {
+template <typename T>
+struct ScalarTraits
+{
+    using Scalar = T;
+    using Reg = T;
+    static constexpr int WIDTH = 1;
+    static constexpr int FULL_MASK = 1;
+
+    static Reg load(const T *data) { return *data; }
+    static void store(T *data, Reg x) { *data = x; }
+    static Reg set1(T x) { return x; }
+    static Reg zero() { return T(); }
+    static Reg add(Reg a, Reg b) { return a + b; }
+    static Reg mul(Reg a, Reg b) { return a * b; }
+    static Reg min(Reg a, Reg b) { return b < a ? b : a; }
+    static Reg max(Reg a, Reg b) { return a < b ? b : a; }
+    template <int comparison>
+    static int compareMask(Reg a, Reg b)
+    {
+        return VectorizedKernels<ScalarTraits>::template compare<comparison>(a, b) ? 1 : 0;
+    }
+    static T lane(Reg x, int) { return x; }
+};
+
+#ifdef PROOF_SEED_SSE2_KERNELS
+struct Sse2Float
+{
+    using Scalar = float;
+    using Reg = __m128;
+    static constexpr int WIDTH = 4;
+    static constexpr int FULL_MASK = 0xF;
+
+    static Reg load(const float *data) { return _mm_loadu_ps(data); }
+    static void store(float *data, Reg x) { _mm_storeu_ps(data, x); }
+    static Reg set1(float x) { return _mm_set1_ps(x); }
+    static Reg zero() { return _mm_setzero_ps(); }
+    static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+    static Reg min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+    template <int comparison>
+    static int compareMask(Reg a, Reg b)
+    {
+        switch (comparison) {
+        case 0:
+            return _mm_movemask_ps(_mm_cmpgt_ps(a, b));
+        case 1:
+            return _mm_movemask_ps(_mm_cmpge_ps(a, b));
+        case 2:
+            return _mm_movemask_ps(_mm_cmplt_ps(a, b));
+        default:
+            return _mm_movemask_ps(_mm_cmple_ps(a, b));
+        }
+    }
+    static float lane(Reg x, int lane)
+    {
+        alignas(16) float lanes[WIDTH];
+        _mm_store_ps(lanes, x);
+        return lanes[lane];
+    }
+};
+
+struct Sse2Double
+{
+    using Scalar = double;
+    using Reg = __m128d;
+    static constexpr int WIDTH = 2;
+    static constexpr int FULL_MASK = 0x3;
+
+    static Reg load(const double *data) { return _mm_loadu_pd(data); }
+    static void store(double *data, Reg x) { _mm_storeu_pd(data, x); }
+    static Reg set1(double x) { return _mm_set1_pd(x); }
+    static Reg zero() { return _mm_setzero_pd(); }
+    static Reg add(Reg a, Reg b) { return _mm_add_pd(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm_mul_pd(a, b); }
+    static Reg min(Reg a, Reg b) { return _mm_min_pd(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm_max_pd(a, b); }
+    template <int comparison>
+    static int compareMask(Reg a, Reg b)
+    {
+        switch (comparison) {
+        case 0:
+            return _mm_movemask_pd(_mm_cmpgt_pd(a, b));
+        case 1:
+            return _mm_movemask_pd(_mm_cmpge_pd(a, b));
+        case 2:
+            return _mm_movemask_pd(_mm_cmplt_pd(a, b));
+        default:
+            return _mm_movemask_pd(_mm_cmple_pd(a, b));
+        }
+    }
+    static double lane(Reg x, int lane)
+    {
+        alignas(16) double lanes[WIDTH];
+        _mm_store_pd(lanes, x);
+        return lanes[lane];
+    }
+};
+
+// SSE2 has only equality and greater comparisons for integers, others are their negations
+struct Sse2Int
+{
+    using Scalar = int;
+    using Reg = __m128i;
+    static constexpr int WIDTH = 4;
+    static constexpr int FULL_MASK = 0xF;
+
+    static Reg load(const int *data) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)); }
+    static void store(int *data, Reg x) { _mm_storeu_si128(reinterpret_cast<__m128i *>(data), x); }
+    static Reg set1(int x) { return _mm_set1_epi32(x); }
+    static Reg zero() { return _mm_setzero_si128(); }
+    static Reg add(Reg a, Reg b) { return _mm_add_epi32(a, b); }
+    // No 32-bit multiplication in SSE2, even and odd lanes are multiplied separately and low halves are merged
+    static Reg mul(Reg a, Reg b)
+    {
+        const Reg even = _mm_mul_epu32(a, b);
+        const Reg odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+    static Reg select(Reg mask, Reg a, Reg b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+    static Reg min(Reg a, Reg b) { return select(_mm_cmpgt_epi32(a, b), b, a); }
+    static Reg max(Reg a, Reg b) { return select(_mm_cmpgt_epi32(a, b), a, b); }
+    static int movemask(Reg x) { return _mm_movemask_ps(_mm_castsi128_ps(x)); }
+    template <int comparison>
+    static int compareMask(Reg a, Reg b)
+    {
+        switch (comparison) {
+        case 0:
+            return movemask(_mm_cmpgt_epi32(a, b));
+        case 1:
+            return movemask(_mm_cmpgt_epi32(b, a)) ^ FULL_MASK;
+        case 2:
+            return movemask(_mm_cmpgt_epi32(b, a));
+        default:
+            return movemask(_mm_cmpgt_epi32(a, b)) ^ FULL_MASK;
+        }
+    }
+    static int lane(Reg x, int lane)
+    {
+        alignas(16) int lanes[WIDTH];
+        _mm_store_si128(reinterpret_cast<__m128i *>(lanes), x);
+        return lanes[lane];
+    }
+};
+
+using BaselineFloat = Sse2Float;
+using BaselineDouble = Sse2Double;
+using BaselineInt = Sse2Int;
+#else
+using BaselineFloat = ScalarTraits<float>;
+using BaselineDouble = ScalarTraits<double>;
+using BaselineInt = ScalarTraits<int>;
+#endif
+
+#ifdef PROOF_SEED_AVX2_KERNELS
+bool avx2Supported()
+{
+#    ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // AVX registers should be also enabled by OS
+    const bool osSupportsAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28));
+    if (!osSupportsAvx || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#    else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#    endif
+}
+#endif
+
+template <typename T>
+VectorizedKernelsTable<T> selectKernels();
+
+template <>
+VectorizedKernelsTable<float> selectKernels<float>()
+{
+#ifdef PROOF_SEED_AVX2_KERNELS
+    if (avx2Supported())
+        return avx2FloatKernels();
+#endif
+    return VectorizedKernels<BaselineFloat>::table();
+}
+
+template <>
+VectorizedKernelsTable<double> selectKernels<double>()
+{
+#ifdef PROOF_SEED_AVX2_KERNELS
+    if (avx2Supported())
+        return avx2DoubleKernels();
+#endif
+    return VectorizedKernels<BaselineDouble>::table();
+}
+
+template <>
+VectorizedKernelsTable<int> selectKernels<int>()
+{
+#ifdef PROOF_SEED_AVX2_KERNELS
+    if (avx2Supported())
+        return avx2IntKernels();
+#endif
+    return VectorizedKernels<BaselineInt>::table();
+}
+
+template <typename T>
+const VectorizedKernelsTable<T> &kernels()
+{
+    static const VectorizedKernelsTable<T> table = selectKernels<T>();
+    return table;
+}
+} // namespace
+
+namespace Proof {
+namespace algorithms {
+namespace detail {
+float vectorizedSum(const float *data, long long size) noexcept
+{
+    return kernels<float>().sum(data, size);
+}
+
+double vectorizedSum(const double *data, long long size) noexcept
+{
+    return kernels<double>().sum(data, size);
+}
+
+int vectorizedSum(const int *data, long long size) noexcept
+{
+    return kernels<int>().sum(data, size);
+}
+
+float vectorizedMin(const float *data, long long size) noexcept
+{
+    return kernels<float>().min(data, size);
+}
+
+double vectorizedMin(const double *data, long long size) noexcept
+{
+    return kernels<double>().min(data, size);
+}
+
+int vectorizedMin(const int *data, long long size) noexcept
+{
+    return kernels<int>().min(data, size);
+}
+
+float vectorizedMax(const float *data, long long size) noexcept
+{
+    return kernels<float>().max(data, size);
+}
+
+double vectorizedMax(const double *data, long long size) noexcept
+{
+    return kernels<double>().max(data, size);
+}
+
+int vectorizedMax(const int *data, long long size) noexcept
+{
+    return kernels<int>().max(data, size);
+}
+
+void vectorizedScale(const float *data, float *destination, long long size, float factor, float offset) noexcept
+{
+    kernels<float>().scale(data, destination, size, factor, offset);
+}
+
+void vectorizedScale(const double *data, double *destination, long long size, double factor, double offset) noexcept
+{
+    kernels<double>().scale(data, destination, size, factor, offset);
+}
+
+void vectorizedScale(const int *data, int *destination, long long size, int factor, int offset) noexcept
+{
+    kernels<int>().scale(data, destination, size, factor, offset);
+}
+
+long long vectorizedFilter(const float *data, float *destination, long long size, VectorizedComparison comparison,
+                           float threshold) noexcept
+{
+    return kernels<float>().filter[static_cast<int>(comparison)](data, destination, size, threshold);
+}
+
+long long vectorizedFilter(const double *data, double *destination, long long size, VectorizedComparison comparison,
+                           double threshold) noexcept
+{
+    return kernels<double>().filter[static_cast<int>(comparison)](data, destination, size, threshold);
+}
+
+long long vectorizedFilter(const int *data, int *destination, long long size, VectorizedComparison comparison,
+                           int threshold) noexcept
+{
+    return kernels<int>().filter[static_cast<int>(comparison)](data, destination, size, threshold);
+}
+
+bool vectorizedExists(const float *data, long long size, VectorizedComparison comparison, float threshold) noexcept
+{
+    return kernels<float>().exists[static_cast<int>(comparison)](data, size, threshold);
+}
+
+bool vectorizedExists(const double *data, long long size, VectorizedComparison comparison, double threshold) noexcept
+{
+    return kernels<double>().exists[static_cast<int>(comparison)](data, size, threshold);
+}
+
+bool vectorizedExists(const int *data, long long size, VectorizedComparison comparison, int threshold) noexcept
+{
+    return kernels<int>().exists[static_cast<int>(comparison)](data, size, threshold);
+}
+} // namespace detail
+} // namespace algorithms
+} // namespace Proof
@@ -0,0 +1,178 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+// This file is compiled with AVX2 enabled and its functions are called only after runtime check of cpu support.
+// It shouldn't include anything that can produce inline functions shared with other translation units.
+#include "vectorizedkernels_p.h"
+
+#ifdef __AVX2__
+#    include <immintrin.h>
+
+namespace {
+template <int comparison>
+struct Avx2Predicate;
+
+template <>
+struct Avx2Predicate<0>
+{
+    static constexpr int VALUE = _CMP_GT_OQ;
+};
+
+template <>
+struct Avx2Predicate<1>
+{
+    static constexpr int VALUE = _CMP_GE_OQ;
+};
+
+template <>
+struct Avx2Predicate<2>
+{
+    static constexpr int VALUE = _CMP_LT_OQ;
+};
+
+template <>
+struct Avx2Predicate<3>
+{
+    static constexpr int VALUE = _CMP_LE_OQ;
+};
+
+struct Avx2Float
+{
+    using Scalar = float;
+    using Reg = __m256;
+    static constexpr int WIDTH = 8;
+    static constexpr int FULL_MASK = 0xFF;
+
+    static Reg load(const float *data) { return _mm256_loadu_ps(data); }
+    static void store(float *data, Reg x) { _mm256_storeu_ps(data, x); }
+    static Reg set1(float x) { return _mm256_set1_ps(x); }
+    static Reg zero() { return _mm256_setzero_ps(); }
+    static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+    static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+    template <int comparison>
+    static int compareMask(Reg a, Reg b)
+    {
+        return _mm256_movemask_ps(_mm256_cmp_ps(a, b, Avx2Predicate<comparison>::VALUE));
+    }
+    static float lane(Reg x, int lane)
+    {
+        alignas(32) float lanes[WIDTH];
+        _mm256_store_ps(lanes, x);
+        return lanes[lane];
+    }
+};
+
+struct Avx2Double
+{
+    using Scalar = double;
+    using Reg = __m256d;
+    static constexpr int WIDTH = 4;
+    static constexpr int FULL_MASK = 0xF;
+
+    static Reg load(const double *data) { return _mm256_loadu_pd(data); }
+    static void store(double *data, Reg x) { _mm256_storeu_pd(data, x); }
+    static Reg set1(double x) { return _mm256_set1_pd(x); }
+    static Reg zero() { return _mm256_setzero_pd(); }
+    static Reg add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+    static Reg min(Reg a, Reg b) { return _mm256_min_pd(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm256_max_pd(a, b); }
+    template <int comparison>
+    static int compareMask(Reg a, Reg b)
+    {
+        return _mm256_movemask_pd(_mm256_cmp_pd(a, b, Avx2Predicate<comparison>::VALUE));
+    }
+    static double lane(Reg x, int lane)
+    {
+        alignas(32) double lanes[WIDTH];
+        _mm256_store_pd(lanes, x);
+        return lanes[lane];
+    }
+};
+
+// AVX2 has only equality and greater comparisons for integers, others are their negations
+struct Avx2Int
+{
+    using Scalar = int;
+    using Reg = __m256i;
+    static constexpr int WIDTH = 8;
+    static constexpr int FULL_MASK = 0xFF;
+
+    static Reg load(const int *data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)); }
+    static void store(int *data, Reg x) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), x); }
+    static Reg set1(int x) { return _mm256_set1_epi32(x); }
+    static Reg zero() { return _mm256_setzero_si256(); }
+    static Reg add(Reg a, Reg b) { return _mm256_add_epi32(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm256_mullo_epi32(a, b); }
+    static Reg min(Reg a, Reg b) { return _mm256_min_epi32(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm256_max_epi32(a, b); }
+    static int movemask(Reg x) { return _mm256_movemask_ps(_mm256_castsi256_ps(x)); }
+    template <int comparison>
+    static int compareMask(Reg a, Reg b)
+    {
+        switch (comparison) {
+        case 0:
+            return movemask(_mm256_cmpgt_epi32(a, b));
+        case 1:
+            return movemask(_mm256_cmpgt_epi32(b, a)) ^ FULL_MASK;
+        case 2:
+            return movemask(_mm256_cmpgt_epi32(b, a));
+        default:
+            return movemask(_mm256_cmpgt_epi32(a, b)) ^ FULL_MASK;
+        }
+    }
+    static int lane(Reg x, int lane)
+    {
+        alignas(32) int lanes[WIDTH];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), x);
+        return lanes[lane];
+    }
+};
+} // namespace
+
+namespace Proof {
+namespace algorithms {
+namespace detail {
+VectorizedKernelsTable<float> avx2FloatKernels()
+{
+    return VectorizedKernels<Avx2Float>::table();
+}
+
+VectorizedKernelsTable<double> avx2DoubleKernels()
+{
+    return VectorizedKernels<Avx2Double>::table();
+}
+
+VectorizedKernelsTable<int> avx2IntKernels()
+{
+    return VectorizedKernels<Avx2Int>::table();
+}
+} // namespace detail
+} // namespace algorithms
+} // namespace Proof
+#endif
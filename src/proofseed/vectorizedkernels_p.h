@@ -0,0 +1,201 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#ifndef PROOFSEED_VECTORIZEDKERNELS_P_H
+#define PROOFSEED_VECTORIZEDKERNELS_P_H
+
+// Included only by kernels translation units, some of them are compiled with extra instruction sets.
+// Kernels are instantiated there with traits from anonymous namespaces, so these instantiations are never merged
+// with code for other instruction sets. For the same reason this header doesn't include any other headers.
+
+namespace Proof {
+namespace algorithms {
+namespace detail {
+// Indices are values of VectorizedComparison
+template <typename T>
+struct VectorizedKernelsTable
+{
+    T (*sum)(const T *, long long);
+    T (*min)(const T *, long long);
+    T (*max)(const T *, long long);
+    void (*scale)(const T *, T *, long long, T, T);
+    long long (*filter[4])(const T *, T *, long long, T);
+    bool (*exists[4])(const T *, long long, T);
+};
+
+VectorizedKernelsTable<float> avx2FloatKernels();
+VectorizedKernelsTable<double> avx2DoubleKernels();
+VectorizedKernelsTable<int> avx2IntKernels();
+
+// V provides Scalar, Reg, WIDTH, FULL_MASK and load, store, set1, zero, add, mul, min, max, compareMask, lane
+template <typename V>
+struct VectorizedKernels
+{
+    using T = typename V::Scalar;
+    using Reg = typename V::Reg;
+    static constexpr long long WIDTH = V::WIDTH;
+
+    static T sum(const T *data, long long size)
+    {
+        // Two accumulators hide latency of dependent additions
+        Reg acc0 = V::zero();
+        Reg acc1 = V::zero();
+        long long i = 0;
+        for (; i + 2 * WIDTH <= size; i += 2 * WIDTH) {
+            acc0 = V::add(acc0, V::load(data + i));
+            acc1 = V::add(acc1, V::load(data + i + WIDTH));
+        }
+        if (i + WIDTH <= size) {
+            acc0 = V::add(acc0, V::load(data + i));
+            i += WIDTH;
+        }
+        acc0 = V::add(acc0, acc1);
+        T result = V::lane(acc0, 0);
+        for (int lane = 1; lane < WIDTH; ++lane)
+            result += V::lane(acc0, lane);
+        for (; i < size; ++i)
+            result += data[i];
+        return result;
+    }
+
+    static T min(const T *data, long long size)
+    {
+        T result = data[0];
+        long long i = 1;
+        if (size >= WIDTH) {
+            Reg acc = V::load(data);
+            for (i = WIDTH; i + WIDTH <= size; i += WIDTH)
+                acc = V::min(acc, V::load(data + i));
+            result = V::lane(acc, 0);
+            for (int lane = 1; lane < WIDTH; ++lane)
+                result = V::lane(acc, lane) < result ? V::lane(acc, lane) : result;
+        }
+        for (; i < size; ++i)
+            result = data[i] < result ? data[i] : result;
+        return result;
+    }
+
+    static T max(const T *data, long long size)
+    {
+        T result = data[0];
+        long long i = 1;
+        if (size >= WIDTH) {
+            Reg acc = V::load(data);
+            for (i = WIDTH; i + WIDTH <= size; i += WIDTH)
+                acc = V::max(acc, V::load(data + i));
+            result = V::lane(acc, 0);
+            for (int lane = 1; lane < WIDTH; ++lane)
+                result = result < V::lane(acc, lane) ? V::lane(acc, lane) : result;
+        }
+        for (; i < size; ++i)
+            result = result < data[i] ? data[i] : result;
+        return result;
+    }
+
+    // No fused multiply-add, so results are same as in scalar version (integers wrap around on overflow)
+    static void scale(const T *data, T *destination, long long size, T factor, T offset)
+    {
+        const Reg factorReg = V::set1(factor);
+        const Reg offsetReg = V::set1(offset);
+        long long i = 0;
+        for (; i + WIDTH <= size; i += WIDTH)
+            V::store(destination + i, V::add(V::mul(V::load(data + i), factorReg), offsetReg));
+        for (; i < size; ++i)
+            destination[i] = data[i] * factor + offset;
+    }
+
+    template <int comparison>
+    static bool compare(T x, T threshold)
+    {
+        switch (comparison) {
+        case 0:
+            return x > threshold;
+        case 1:
+            return x >= threshold;
+        case 2:
+            return x < threshold;
+        default:
+            return x <= threshold;
+        }
+    }
+
+    template <int comparison>
+    static long long filter(const T *data, T *destination, long long size, T threshold)
+    {
+        const Reg thresholdReg = V::set1(threshold);
+        long long count = 0;
+        long long i = 0;
+        for (; i + WIDTH <= size; i += WIDTH) {
+            const Reg x = V::load(data + i);
+            const int mask = V::template compareMask<comparison>(x, thresholdReg);
+            if (mask == V::FULL_MASK) {
+                V::store(destination + count, x);
+                count += WIDTH;
+            } else if (mask) {
+                for (int lane = 0; lane < WIDTH; ++lane) {
+                    if (mask & (1 << lane))
+                        destination[count++] = data[i + lane];
+                }
+            }
+        }
+        for (; i < size; ++i) {
+            if (compare<comparison>(data[i], threshold))
+                destination[count++] = data[i];
+        }
+        return count;
+    }
+
+    template <int comparison>
+    static bool exists(const T *data, long long size, T threshold)
+    {
+        const Reg thresholdReg = V::set1(threshold);
+        long long i = 0;
+        for (; i + WIDTH <= size; i += WIDTH) {
+            if (V::template compareMask<comparison>(V::load(data + i), thresholdReg))
+                return true;
+        }
+        for (; i < size; ++i) {
+            if (compare<comparison>(data[i], threshold))
+                return true;
+        }
+        return false;
+    }
+
+    static VectorizedKernelsTable<T> table()
+    {
+        return VectorizedKernelsTable<T>{&sum,
+                                         &min,
+                                         &max,
+                                         &scale,
+                                         {&filter<0>, &filter<1>, &filter<2>, &filter<3>},
+                                         {&exists<0>, &exists<1>, &exists<2>, &exists<3>}};
+    }
+};
+} // namespace detail
+} // namespace algorithms
+} // namespace Proof
+
+#endif // PROOFSEED_VECTORIZEDKERNELS_P_H
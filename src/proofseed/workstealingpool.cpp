@@ -0,0 +1,320 @@
+/* Copyright 2019, OpenSoft Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *     * Neither the name of OpenSoft Inc. nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: denis.kormalev@opensoftdev.com (Denis Kormalev)
+ *
+ */
+#include "proofseed/workstealingpool.h"
+
+#include "proofseed/asynqro_extra.h"
+#include "proofseed/memorypool.h"
+
+#include <deque>
+#include <limits>
+#include <thread>
+
+using namespace Proof::tasks;
+
+namespace {
+// Amount of empty search rounds before worker goes to sleep. Kept small to not burn CPU next to asynqro workers
+constexpr int SPIN_ROUNDS = 4;
+
+// Chase-Lev deque (with fixes from "Correct and Efficient Work-Stealing for Weak Memory Models").
+// Owner pushes and pops at bottom, thieves steal from top. Buffers replaced by growth are kept
+// till deque destruction, because thieves can still read from them.
+template <typename T>
+class ChaseLevDeque
+{
+public:
+    ChaseLevDeque() : m_buffer(new Buffer(64)) {}
+    ChaseLevDeque(const ChaseLevDeque &) = delete;
+    ChaseLevDeque(ChaseLevDeque &&) = delete;
+    ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+    ChaseLevDeque &operator=(ChaseLevDeque &&) = delete;
+    ~ChaseLevDeque()
+    {
+        delete m_buffer.load();
+        for (Buffer *buffer : m_retired)
+            delete buffer;
+    }
+
+    void push(T *value)
+    {
+        const long long bottom = m_bottom.load(std::memory_order_relaxed);
+        const long long top = m_top.load(std::memory_order_acquire);
+        Buffer *buffer = m_buffer.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->mask) {
+            Buffer *grown = new Buffer((buffer->mask + 1) * 2);
+            for (long long i = top; i < bottom; ++i)
+                grown->put(i, buffer->get(i));
+            m_retired.push_back(buffer);
+            buffer = grown;
+            m_buffer.store(buffer, std::memory_order_release);
+        }
+        buffer->put(bottom, value);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    T *pop()
+    {
+        const long long bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        Buffer *buffer = m_buffer.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_seq_cst);
+        long long top = m_top.load(std::memory_order_seq_cst);
+        if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T *result = buffer->get(bottom);
+        if (top == bottom) {
+            // Last element, race with thieves
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                result = nullptr;
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    T *steal()
+    {
+        long long top = m_top.load(std::memory_order_seq_cst);
+        const long long bottom = m_bottom.load(std::memory_order_seq_cst);
+        if (top >= bottom)
+            return nullptr;
+        Buffer *buffer = m_buffer.load(std::memory_order_acquire);
+        T *result = buffer->get(top);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return result;
+    }
+
+    bool isEmpty() const
+    {
+        return m_top.load(std::memory_order_acquire) >= m_bottom.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Buffer
+    {
+        explicit Buffer(long long size) : mask(size - 1), data(new std::atomic<T *>[static_cast<size_t>(size)]) {}
+        T *get(long long index) const { return data[static_cast<size_t>(index & mask)].load(std::memory_order_relaxed); }
+        void put(long long index, T *value) { data[static_cast<size_t>(index & mask)].store(value, std::memory_order_relaxed); }
+
+        const long long mask;
+        std::unique_ptr<std::atomic<T *>[]> data;
+    };
+
+    alignas(64) std::atomic<long long> m_top{0};
+    alignas(64) std::atomic<long long> m_bottom{0};
+    std::atomic<Buffer *> m_buffer;
+    std::vector<Buffer *> m_retired;
+};
+
+std::atomic<Scheduling> currentScheduling{Scheduling::SharedQueue};
+std::atomic<size_t> producersCounter{0};
+
+thread_local const WorkStealingPool *currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+thread_local size_t producerIndex = std::numeric_limits<size_t>::max();
+} // namespace
+
+struct WorkStealingPool::Task : Proof::Pooled
+{
+    explicit Task(UniqueFunction<void()> &&f) : f(std::move(f)) {}
+    UniqueFunction<void()> f;
+};
+
+struct WorkStealingPool::Worker
+{
+    ChaseLevDeque<Task> deque;
+    std::thread thread;
+};
+
+struct WorkStealingPool::InjectionQueue
+{
+    alignas(64) SpinLock lock;
+    std::deque<Task *> tasks;
+    std::atomic<long long> size{0};
+};
+
+WorkStealingPool::WorkStealingPool(qint32 capacity)
+{
+    const size_t count = static_cast<size_t>(qMax(1, capacity));
+    m_workers.reserve(count);
+    m_injectionQueues.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_injectionQueues.push_back(std::make_unique<InjectionQueue>());
+    }
+    for (size_t i = 0; i < count; ++i)
+        m_workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepLock);
+        m_stopping = true;
+    }
+    m_sleepCondition.notify_all();
+    for (const auto &worker : m_workers)
+        worker->thread.join();
+    for (const auto &worker : m_workers) {
+        while (Task *task = worker->deque.steal())
+            delete task;
+    }
+    for (const auto &queue : m_injectionQueues) {
+        for (Task *task : queue->tasks)
+            delete task;
+    }
+}
+
+WorkStealingPool *WorkStealingPool::instance()
+{
+    // Intentionally leaked, tasks can still be posted during static objects destruction
+    static auto *pool = new WorkStealingPool(Runner::instance()->capacity());
+    return pool;
+}
+
+void WorkStealingPool::setScheduling(Scheduling scheduling) noexcept
+{
+    currentScheduling = scheduling;
+}
+
+Scheduling WorkStealingPool::scheduling() noexcept
+{
+    return currentScheduling.load(std::memory_order_relaxed);
+}
+
+qint32 WorkStealingPool::capacity() const noexcept
+{
+    return static_cast<qint32>(m_workers.size());
+}
+
+bool WorkStealingPool::isWorkerThread() const noexcept
+{
+    return currentPool == this;
+}
+
+void WorkStealingPool::post(UniqueFunction<void()> &&f) noexcept
+{
+    Task *task = nullptr;
+    try {
+        task = new Task(std::move(f));
+    } catch (...) {
+        return;
+    }
+    if (currentPool == this) {
+        m_workers[currentWorkerIndex]->deque.push(task);
+    } else {
+        if (producerIndex == std::numeric_limits<size_t>::max())
+            producerIndex = producersCounter++;
+        InjectionQueue *queue = m_injectionQueues[producerIndex % m_injectionQueues.size()].get();
+        SpinLockHolder lock(&queue->lock);
+        queue->tasks.push_back(task);
+        ++queue->size;
+    }
+    // Pairs with fence in workerLoop, either worker sees this task or we see that worker is going to sleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) > 0)
+        wakeOne();
+}
+
+void WorkStealingPool::workerLoop(size_t index)
+{
+    currentPool = this;
+    currentWorkerIndex = index;
+    int idleRounds = 0;
+    while (!m_stopping) {
+        if (Task *task = findTask(index)) {
+            try {
+                task->f();
+            } catch (...) {
+            }
+            delete task;
+            idleRounds = 0;
+            continue;
+        }
+        if (++idleRounds < SPIN_ROUNDS) {
+            std::this_thread::yield();
+            continue;
+        }
+        idleRounds = 0;
+        std::unique_lock<std::mutex> lock(m_sleepLock);
+        ++m_sleepers;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!m_stopping && !hasVisibleTasks())
+            m_sleepCondition.wait(lock, [this]() { return m_wakeups > 0 || m_stopping; });
+        if (m_wakeups > 0)
+            --m_wakeups;
+        --m_sleepers;
+    }
+}
+
+WorkStealingPool::Task *WorkStealingPool::findTask(size_t index)
+{
+    if (Task *task = m_workers[index]->deque.pop())
+        return task;
+
+    const size_t count = m_workers.size();
+    for (size_t i = 0; i < count; ++i) {
+        InjectionQueue *queue = m_injectionQueues[(index + i) % count].get();
+        if (!queue->size.load(std::memory_order_acquire))
+            continue;
+        SpinLockHolder lock(&queue->lock);
+        if (queue->tasks.empty())
+            continue;
+        Task *task = queue->tasks.front();
+        queue->tasks.pop_front();
+        --queue->size;
+        return task;
+    }
+
+    for (size_t i = 1; i < count; ++i) {
+        if (Task *task = m_workers[(index + i) % count]->deque.steal())
+            return task;
+    }
+    return nullptr;
+}
+
+bool WorkStealingPool::hasVisibleTasks() const
+{
+    for (const auto &worker : m_workers) {
+        if (!worker->deque.isEmpty())
+            return true;
+    }
+    for (const auto &queue : m_injectionQueues) {
+        if (queue->size.load(std::memory_order_acquire))
+            return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::wakeOne()
+{
+    std::lock_guard<std::mutex> lock(m_sleepLock);
+    if (m_wakeups < m_sleepers.load(std::memory_order_relaxed)) {
+        ++m_wakeups;
+        m_sleepCondition.notify_one();
+    }
+}
@@ -10,6 +10,7 @@
 #include <QSet>
 #include <QVector>
 
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -104,3 +105,46 @@ TEST(AlgorithmsTest, flatFilterQVectorQSetShort)
     for (int i = 0; i < 9; ++i)
         EXPECT_EQ(i * 2, resultVector[i]);
 }
+
+TEST(AlgorithmsTest, flatFilterRvalue)
+{
+    std::vector<std::vector<std::unique_ptr<int>>> testContainer(5);
+    for (int i = 0; i < 20; ++i)
+        testContainer[static_cast<size_t>(i % 5)].push_back(std::make_unique<int>(i));
+    std::vector<std::unique_ptr<int>> result = algorithms::flatFilter(std::move(testContainer),
+                                                                      [](const std::unique_ptr<int> &x) { return *x % 2; });
+    ASSERT_EQ(10u, result.size());
+    std::sort(result.begin(), result.end(), [](const auto &left, const auto &right) { return *left < *right; });
+    for (size_t i = 0; i < result.size(); ++i)
+        EXPECT_EQ(static_cast<int>(i) * 2 + 1, *result[i]);
+
+    QVector<QVector<QString>> strings = {{"a", "b"}, {}, {"c"}};
+    QVector<QVector<QString>> stringsCopy = strings;
+    QVector<QString> flattened = algorithms::flatten(std::move(strings));
+    EXPECT_EQ(QVector<QString>({"a", "b", "c"}), flattened);
+    EXPECT_EQ(3, stringsCopy.size());
+    EXPECT_EQ(2, stringsCopy[0].size());
+}
+
+TEST(AlgorithmsTest, flatFilterReserve)
+{
+    QVector<QVector<int>> testContainer = {{0}, {1, 2, 3}, {4, 5}, {}, {6, 7, 8, 9}, {10, 11, 12, 13, 14}, {15, 16}};
+    auto isEven = [](int x) { return !(x % 2); };
+    QVector<int> expected = {0, 2, 4, 6, 8, 10, 12, 14, 16};
+
+    QVector<int> notReserved = algorithms::flatFilter(testContainer, isEven);
+    EXPECT_EQ(expected, notReserved);
+
+    QVector<int> upperBound = algorithms::flatFilter(testContainer, isEven, algorithms::ReserveMode::UpperBound);
+    EXPECT_EQ(expected, upperBound);
+    EXPECT_GE(upperBound.capacity(), 17);
+
+    QVector<int> shrunk = algorithms::flatFilter(testContainer, isEven, algorithms::ReserveMode::ShrinkToFit);
+    EXPECT_EQ(expected, shrunk);
+    EXPECT_EQ(9, shrunk.capacity());
+
+    QVector<int> appended = algorithms::flatFilter(testContainer, isEven, QVector<int>{-2},
+                                                   algorithms::ReserveMode::None);
+    expected.insert(expected.begin(), -2);
+    EXPECT_EQ(expected, appended);
+}
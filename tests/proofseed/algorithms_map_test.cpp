@@ -15,6 +15,27 @@
 
 using namespace Proof;
 
+namespace {
+struct CopyCounted
+{
+    CopyCounted(int value = 0) : value(value) {}
+    CopyCounted(const CopyCounted &other) : value(other.value) { ++copies; }
+    CopyCounted(CopyCounted &&other) noexcept = default;
+    CopyCounted &operator=(const CopyCounted &other)
+    {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    CopyCounted &operator=(CopyCounted &&other) noexcept = default;
+    bool operator<(const CopyCounted &other) const { return value < other.value; }
+
+    int value;
+    static int copies;
+};
+int CopyCounted::copies = 0;
+} // namespace
+
 template <typename T>
 std::vector<T> setToVector(const std::set<T> &x)
 {
@@ -371,3 +392,94 @@ TEST(AlgorithmsTest, toValuesList)
     for (int i = 1; i <= 9; ++i)
         EXPECT_EQ(i + 10, result[i - 1]);
 }
+
+TEST(AlgorithmsTest, toContainersFromRvalue)
+{
+    QVector<int> qVector = {1, 2, 3, 4, 5};
+    const int *qVectorData = qVector.constData();
+    QVector<int> sameVector = algorithms::toVector(std::move(qVector));
+    EXPECT_EQ(qVectorData, sameVector.constData());
+    EXPECT_EQ(QVector<int>({1, 2, 3, 4, 5}), sameVector);
+
+    std::vector<CopyCounted> stdVector = {1, 2, 3, 4, 5};
+    CopyCounted::copies = 0;
+    QVector<CopyCounted> converted = algorithms::toVector(std::move(stdVector));
+    EXPECT_EQ(0, CopyCounted::copies);
+    ASSERT_EQ(5, converted.size());
+    for (int i = 0; i < 5; ++i)
+        EXPECT_EQ(i + 1, converted[i].value);
+
+    QVector<QString> strings = {"a", "b", "c"};
+    QVector<QString> stringsCopy = strings;
+    QList<QString> stringsList = algorithms::toList(std::move(strings));
+    EXPECT_EQ(QList<QString>({"a", "b", "c"}), stringsList);
+    EXPECT_EQ(QVector<QString>({"a", "b", "c"}), stringsCopy);
+
+    QSet<int> set = algorithms::toSet(std::move(sameVector));
+    EXPECT_EQ(QSet<int>({1, 2, 3, 4, 5}), set);
+}
+
+TEST(AlgorithmsTest, toKeysAndValuesFromRvalue)
+{
+    QMap<int, CopyCounted> qMap;
+    std::map<CopyCounted, int> stdMap;
+    for (int i = 1; i <= 9; ++i) {
+        qMap[i] = CopyCounted(i + 10);
+        stdMap[CopyCounted(i)] = i + 10;
+    }
+    QMap<int, CopyCounted> qMapCopy = qMap;
+
+    CopyCounted::copies = 0;
+    QVector<CopyCounted> values = algorithms::toValuesVector(std::move(qMap));
+    QVector<CopyCounted> keys = algorithms::toKeysVector(std::move(stdMap));
+    EXPECT_EQ(0, CopyCounted::copies);
+    ASSERT_EQ(9, values.size());
+    ASSERT_EQ(9, keys.size());
+    for (int i = 1; i <= 9; ++i) {
+        EXPECT_EQ(i + 10, values[i - 1].value);
+        EXPECT_EQ(i, keys[i - 1].value);
+        EXPECT_EQ(i + 10, qMapCopy[i].value);
+    }
+
+    QList<int> qMapKeys = algorithms::toKeysList(std::move(qMapCopy));
+    EXPECT_EQ(QList<int>({1, 2, 3, 4, 5, 6, 7, 8, 9}), qMapKeys);
+}
+
+TEST(AlgorithmsTest, mapRvalue)
+{
+    QVector<int> qVector = {1, 2, 3, 4, 5};
+    const int *qVectorData = qVector.constData();
+    QVector<int> doubled = algorithms::map(std::move(qVector), [](int x) { return x * 2; });
+    EXPECT_EQ(qVectorData, doubled.constData());
+    EXPECT_EQ(QVector<int>({2, 4, 6, 8, 10}), doubled);
+
+    QVector<CopyCounted> counted = {1, 2, 3, 4, 5};
+    CopyCounted::copies = 0;
+    QVector<int> unwrapped = algorithms::map(std::move(counted), [](CopyCounted x) { return x.value; });
+    EXPECT_EQ(0, CopyCounted::copies);
+    EXPECT_EQ(QVector<int>({1, 2, 3, 4, 5}), unwrapped);
+
+    std::vector<CopyCounted> stdVector = {1, 2, 3, 4, 5};
+    CopyCounted::copies = 0;
+    QVector<CopyCounted> moved = algorithms::map(std::move(stdVector), [](CopyCounted x) { return x; },
+                                                 QVector<CopyCounted>());
+    EXPECT_EQ(0, CopyCounted::copies);
+    ASSERT_EQ(5, moved.size());
+    for (int i = 0; i < 5; ++i)
+        EXPECT_EQ(i + 1, moved[i].value);
+}
+
+TEST(AlgorithmsTest, filterRvalue)
+{
+    std::vector<int> stdVector = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    const int *stdVectorData = stdVector.data();
+    std::vector<int> odd = algorithms::filter(std::move(stdVector), [](int x) { return x % 2; });
+    EXPECT_EQ(stdVectorData, odd.data());
+    EXPECT_EQ(std::vector<int>({1, 3, 5, 7, 9}), odd);
+
+    QVector<QString> strings = {"a", "bb", "c", "dd"};
+    QVector<QString> stringsCopy = strings;
+    QVector<QString> shortStrings = algorithms::filter(std::move(strings), [](const QString &x) { return x.size() < 2; });
+    EXPECT_EQ(QVector<QString>({"a", "c"}), shortStrings);
+    EXPECT_EQ(QVector<QString>({"a", "bb", "c", "dd"}), stringsCopy);
+}
@@ -0,0 +1,413 @@
+// clazy:skip
+
+#include "proofseed/parallelalgorithms.h"
+
+#include "gtest/proof/test_global.h"
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QVector>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace Proof;
+
+TEST(ParallelAlgorithmsTest, forEach)
+{
+    QVector<long long> testContainer;
+    for (long long i = 0; i < 100000; ++i)
+        testContainer << i;
+    std::atomic<long long> sum{0};
+    std::atomic<long long> calls{0};
+    algorithms::forEach(algorithms::par.withThreshold(0), testContainer, [&sum, &calls](long long x) {
+        sum += x;
+        ++calls;
+    });
+    EXPECT_EQ(100000, calls);
+    EXPECT_EQ(99999ll * 100000ll / 2, sum);
+}
+
+TEST(ParallelAlgorithmsTest, forEachWithIndices)
+{
+    std::vector<int> testContainer(100000, 2);
+    std::vector<std::atomic<int>> visited(testContainer.size());
+    algorithms::forEach(algorithms::par.withThreshold(0), testContainer,
+                        [&visited](long long index, int x) { visited[static_cast<size_t>(index)] += x; });
+    for (size_t i = 0; i < visited.size(); ++i)
+        ASSERT_EQ(2, visited[i]) << i;
+}
+
+TEST(ParallelAlgorithmsTest, forEachSequentialFallback)
+{
+    QVector<int> smallContainer = {1, 2, 3, 4, 5};
+    QSet<int> nonRandomAccessContainer = {1, 2, 3, 4, 5};
+    std::thread::id caller = std::this_thread::get_id();
+    std::atomic_bool otherThreadUsed{false};
+    auto func = [caller, &otherThreadUsed](int) {
+        if (std::this_thread::get_id() != caller)
+            otherThreadUsed = true;
+    };
+    algorithms::forEach(algorithms::par, smallContainer, func);
+    algorithms::forEach(algorithms::par.withThreshold(0), nonRandomAccessContainer, func);
+    algorithms::forEach(algorithms::par.withThreshold(0).withGrainSize(100), smallContainer, func);
+    algorithms::forEach(algorithms::seq, smallContainer, func);
+    EXPECT_FALSE(otherThreadUsed);
+}
+
+TEST(ParallelAlgorithmsTest, mapInPlace)
+{
+    QVector<int> qVector;
+    QList<int> qList;
+    std::vector<int> stdVector;
+    for (int i = 0; i < 50000; ++i) {
+        qVector << i;
+        qList << i;
+        stdVector.push_back(i);
+    }
+    QVector<int> qVectorCopy = qVector;
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+    algorithms::mapInPlace(policy, qVector, [](int x) { return x * 2; });
+    algorithms::mapInPlace(policy, qList, [](int x) { return x * 2; });
+    algorithms::mapInPlace(policy, stdVector, [](long long i, int x) { return x + static_cast<int>(i); });
+    for (int i = 0; i < 50000; ++i) {
+        ASSERT_EQ(i * 2, qVector[i]) << i;
+        ASSERT_EQ(i * 2, qList[i]) << i;
+        ASSERT_EQ(i * 2, stdVector[static_cast<size_t>(i)]) << i;
+        ASSERT_EQ(i, qVectorCopy[i]) << i;
+    }
+}
+
+TEST(ParallelAlgorithmsTest, map)
+{
+    QVector<int> testContainer;
+    for (int i = 0; i < 50000; ++i)
+        testContainer << i;
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+
+    QVector<long long> mapped = algorithms::map(policy, testContainer, [](int x) { return x * 3ll; });
+    ASSERT_EQ(50000, mapped.size());
+    for (int i = 0; i < 50000; ++i)
+        ASSERT_EQ(i * 3ll, mapped[i]) << i;
+
+    QSet<int> mappedSet = algorithms::map(policy, testContainer, [](int x) { return x % 100; }, QSet<int>());
+    ASSERT_EQ(100, mappedSet.size());
+    for (int i = 0; i < 100; ++i)
+        EXPECT_TRUE(mappedSet.contains(i)) << i;
+
+    // Chunk results are moved into destination, so move-only outputs are supported
+    std::vector<std::unique_ptr<int>> pointers = algorithms::map(policy, testContainer,
+                                                                 [](int x) { return std::make_unique<int>(x); },
+                                                                 std::vector<std::unique_ptr<int>>());
+    ASSERT_EQ(50000, pointers.size());
+    for (int i = 0; i < 50000; ++i)
+        ASSERT_EQ(i, *pointers[static_cast<size_t>(i)]) << i;
+}
+
+TEST(ParallelAlgorithmsTest, toSet)
+{
+    QVector<int> qVector;
+    std::vector<int> stdVector;
+    QSet<int> qSet;
+    QHash<int, int> qHash;
+    QMap<int, int> qMap;
+    std::map<int, int> stdMap;
+    for (int i = 0; i < 50000; ++i) {
+        qVector << i % 10000;
+        stdVector.push_back(i);
+        qSet << i;
+        qHash[i] = i % 1000;
+        qMap[i] = i % 1000;
+        stdMap[i] = i % 1000;
+    }
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+
+    EXPECT_EQ(algorithms::toSet(qVector), algorithms::toSet(policy, qVector));
+    EXPECT_EQ(algorithms::toSet(stdVector), algorithms::toSet(policy, stdVector));
+    EXPECT_EQ(qSet, algorithms::toSet(policy, qSet));
+    EXPECT_EQ(algorithms::toSet(qVector), algorithms::toSet(algorithms::seq, qVector));
+    EXPECT_EQ(10000, algorithms::toSet(policy, qVector).size());
+
+    EXPECT_EQ(qSet, algorithms::toKeysSet(policy, qHash));
+    EXPECT_EQ(qSet, algorithms::toKeysSet(policy, qMap));
+    EXPECT_EQ(qSet, algorithms::toKeysSet(policy, stdMap));
+    EXPECT_EQ(algorithms::toValuesSet(qHash), algorithms::toValuesSet(policy, qHash));
+    EXPECT_EQ(algorithms::toValuesSet(stdMap), algorithms::toValuesSet(policy, stdMap));
+    EXPECT_EQ(1000, algorithms::toValuesSet(policy, qMap).size());
+    EXPECT_EQ(algorithms::toKeysSet(qHash), algorithms::toKeysSet(algorithms::seq, qHash));
+
+    struct Ordered
+    {
+        int value;
+        bool operator<(const Ordered &other) const { return value < other.value; }
+    };
+    std::set<Ordered> ordered = algorithms::map(policy, stdVector, [](int x) { return Ordered{x % 300}; },
+                                                std::set<Ordered>());
+    ASSERT_EQ(300u, ordered.size());
+    EXPECT_EQ(0, ordered.begin()->value);
+    EXPECT_EQ(299, ordered.rbegin()->value);
+
+    std::unordered_set<int> initial = {-1, 0, 1};
+    std::unordered_set<int> mapped = algorithms::map(policy, qVector, [](int x) { return x % 5000; }, initial);
+    ASSERT_EQ(5001u, mapped.size());
+    EXPECT_EQ(1u, mapped.count(-1));
+    for (int i = 0; i < 5000; ++i)
+        EXPECT_EQ(1u, mapped.count(i)) << i;
+}
+
+TEST(ParallelAlgorithmsTest, filter)
+{
+    std::vector<int> testContainer;
+    for (int i = 0; i < 50000; ++i)
+        testContainer.push_back(i);
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+    std::vector<int> result = algorithms::filter(policy, testContainer, [](int x) { return !(x % 3); });
+    ASSERT_EQ(16667u, result.size());
+    for (size_t i = 0; i < result.size(); ++i)
+        ASSERT_EQ(static_cast<int>(i) * 3, result[i]) << i;
+}
+
+TEST(ParallelAlgorithmsTest, exceptionPropagation)
+{
+    QVector<int> testContainer;
+    for (int i = 0; i < 10000; ++i)
+        testContainer << i;
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(100);
+    EXPECT_THROW(algorithms::forEach(policy, testContainer,
+                                     [](int x) {
+                                         if (x == 5000)
+                                             throw std::runtime_error("failed");
+                                     }),
+                 std::runtime_error);
+}
+
+TEST(ParallelAlgorithmsTest, exists)
+{
+    QVector<int> testContainer;
+    for (int i = 0; i < 1000000; ++i)
+        testContainer << i;
+    auto policy = algorithms::par.withThreshold(0);
+    std::atomic<long long> calls{0};
+    EXPECT_TRUE(algorithms::exists(policy, testContainer, [&calls](int x) {
+        ++calls;
+        return x == 10;
+    }));
+    EXPECT_LT(calls, 500000);
+    EXPECT_FALSE(algorithms::exists(policy, testContainer, [](int x) { return x < 0; }));
+    EXPECT_TRUE(algorithms::exists(policy, testContainer, [](int x) { return x == 999999; }));
+}
+
+TEST(ParallelAlgorithmsTest, forAll)
+{
+    std::vector<int> testContainer;
+    for (int i = 0; i < 1000000; ++i)
+        testContainer.push_back(i);
+    auto policy = algorithms::par.withThreshold(0);
+    std::atomic<long long> calls{0};
+    EXPECT_FALSE(algorithms::forAll(policy, testContainer, [&calls](int x) {
+        ++calls;
+        return x != 10;
+    }));
+    EXPECT_LT(calls, 500000);
+    EXPECT_TRUE(algorithms::forAll(policy, testContainer, [](int x) { return x >= 0; }));
+}
+
+TEST(ParallelAlgorithmsTest, findIf)
+{
+    QVector<int> testContainer;
+    for (int i = 0; i < 1000000; ++i)
+        testContainer << i % 1000;
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+    std::atomic<long long> calls{0};
+    EXPECT_EQ(500, algorithms::findIf(policy, testContainer,
+                                      [&calls](int x) {
+                                          ++calls;
+                                          return x >= 500;
+                                      },
+                                      -1));
+    EXPECT_LT(calls, 500000);
+    EXPECT_EQ(-1, algorithms::findIf(policy, testContainer, [](int x) { return x > 1000; }, -1));
+}
+
+TEST(ParallelAlgorithmsTest, eraseIf)
+{
+    QVector<qint64> qVector;
+    std::vector<QString> stdVector;
+    for (int i = 0; i < 50000; ++i) {
+        qVector << i;
+        stdVector.push_back(QString::number(i));
+    }
+    QVector<qint64> qVectorCopy = qVector;
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+    algorithms::eraseIf(policy, qVector, [](qint64 x) { return x % 3 || (x > 10000 && x < 20000); });
+    algorithms::eraseIf(policy, stdVector, [](const QString &x) { return x.toInt() % 2; });
+    ASSERT_EQ(13334, qVector.size());
+    for (int i = 0, expected = 0; i < qVector.size(); ++i, expected += 3) {
+        if (expected > 10000 && expected < 20000)
+            expected = 20001;
+        ASSERT_EQ(expected, qVector[i]) << i;
+    }
+    ASSERT_EQ(25000u, stdVector.size());
+    for (size_t i = 0; i < stdVector.size(); ++i)
+        ASSERT_EQ(QString::number(i * 2), stdVector[i]) << i;
+    EXPECT_EQ(50000, qVectorCopy.size());
+}
+
+TEST(ParallelAlgorithmsTest, eraseIfOverlappingChunks)
+{
+    // Mix of fully kept and fully erased chunks makes destinations of chunks overlap sources of previous ones
+    std::vector<QString> stdVector;
+    for (int i = 0; i < 50000; ++i)
+        stdVector.push_back(QString::number(i));
+    auto predicate = [](const QString &x) {
+        const int chunk = x.toInt() / 100;
+        return chunk % 7 == 0 || (chunk % 3 == 0 && x.toInt() % 2) || chunk < 50;
+    };
+    std::vector<QString> expected = stdVector;
+    algorithms::eraseIf(expected, predicate);
+    algorithms::eraseIf(algorithms::par.withThreshold(0).withGrainSize(100), stdVector, predicate);
+    EXPECT_EQ(expected, stdVector);
+}
+
+TEST(ParallelAlgorithmsTest, eraseIfAssociative)
+{
+    QMap<int, int> fewErased;
+    QHash<int, int> manyErased;
+    for (int i = 0; i < 50000; ++i) {
+        fewErased[i] = i * 2;
+        manyErased[i] = i * 2;
+    }
+    QMap<int, int> fewErasedCopy = fewErased;
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+    algorithms::eraseIf(policy, fewErased, [](int key, int) { return !(key % 10); });
+    algorithms::eraseIf(policy, manyErased, [](int, int value) { return value % 10; });
+    ASSERT_EQ(45000, fewErased.size());
+    ASSERT_EQ(10000, manyErased.size());
+    for (int i = 0; i < 50000; ++i) {
+        ASSERT_EQ(static_cast<bool>(i % 10), fewErased.contains(i)) << i;
+        ASSERT_EQ(!(i % 5), manyErased.contains(i)) << i;
+        if (manyErased.contains(i)) {
+            ASSERT_EQ(i * 2, manyErased[i]) << i;
+        }
+    }
+    EXPECT_EQ(50000, fewErasedCopy.size());
+}
+
+TEST(ParallelAlgorithmsTest, makeUnique)
+{
+    QVector<int> qVector;
+    std::vector<QString> stdVector;
+    // Runs of duplicates cross chunks boundaries
+    for (int i = 0; i < 50000; ++i) {
+        qVector << i / 7;
+        stdVector.push_back(QString::number(i / 1500));
+    }
+    qVector << 0 << 0;
+    QVector<int> expected = qVector;
+    algorithms::makeUnique(expected);
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+    algorithms::makeUnique(policy, qVector);
+    algorithms::makeUnique(policy, stdVector);
+    EXPECT_EQ(expected, qVector);
+    ASSERT_EQ(34u, stdVector.size());
+    for (size_t i = 0; i < stdVector.size(); ++i)
+        ASSERT_EQ(QString::number(i), stdVector[i]) << i;
+}
+
+TEST(ParallelAlgorithmsTest, flatFilter)
+{
+    QVector<QVector<int>> testContainer;
+    QVector<QSet<int>> setsContainer;
+    QVector<int> expected;
+    for (int i = 0, value = 0; i < 2000; ++i) {
+        QVector<int> inner;
+        QSet<int> innerSet;
+        // Uneven inner sizes, including empty ones
+        for (int j = 0; j < i % 37; ++j, ++value) {
+            inner << value;
+            innerSet << value;
+            if (value % 3)
+                expected << value;
+        }
+        testContainer << inner;
+        setsContainer << innerSet;
+    }
+    auto predicate = [](int x) { return x % 3; };
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+
+    EXPECT_EQ(expected, algorithms::flatFilter(policy, testContainer, predicate));
+    std::vector<int> stdResult = algorithms::flatFilter(policy, testContainer, predicate, std::vector<int>{-1});
+    ASSERT_EQ(static_cast<size_t>(expected.size()) + 1, stdResult.size());
+    EXPECT_EQ(-1, stdResult[0]);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), stdResult.begin() + 1));
+
+    QSet<int> setResult = algorithms::flatFilter(policy, setsContainer, predicate, QSet<int>());
+    EXPECT_EQ(expected.size(), setResult.size());
+    for (int x : expected)
+        ASSERT_TRUE(setResult.contains(x)) << x;
+    QList<int> listResult = algorithms::flatFilter(policy, setsContainer, predicate, QList<int>());
+    std::sort(listResult.begin(), listResult.end());
+    EXPECT_EQ(expected.toList(), listResult);
+}
+
+TEST(ParallelAlgorithmsTest, reduce)
+{
+    std::vector<int> testContainer;
+    QVector<double> doubles;
+    for (int i = 0; i < 100000; ++i) {
+        testContainer.push_back(i);
+        doubles << (i % 100);
+    }
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+    EXPECT_EQ(99999ll * 100000ll / 2,
+              algorithms::reduce(policy, testContainer, [](long long acc, int x) { return acc + x; }, 0ll,
+                                 [](long long left, long long right) { return left + right; }));
+    EXPECT_EQ(99999, algorithms::reduce(policy, testContainer, [](int acc, int x) { return qMax(acc, x); }, -1));
+    EXPECT_DOUBLE_EQ(99.0 * 100.0 / 2 * 1000, algorithms::reduce(policy, doubles, algorithms::ops::Plus(), 0.0));
+    EXPECT_DOUBLE_EQ(99.0, algorithms::reduce(policy, doubles, algorithms::ops::Max(), -1.0));
+    EXPECT_DOUBLE_EQ(0.0, algorithms::reduce(policy, doubles, algorithms::ops::Min(), 1000.0));
+
+    // Combine is not commutative, order of partials should be kept
+    QString joined = algorithms::reduce(policy, testContainer,
+                                        [](QString acc, int x) {
+                                            if (!(x % 10000))
+                                                acc += QString::number(x / 10000);
+                                            return acc;
+                                        },
+                                        QString(), [](QString left, const QString &right) { return left + right; });
+    EXPECT_EQ("0123456789", joined);
+    EXPECT_EQ(7, algorithms::reduce(algorithms::seq, testContainer, [](int, int) { return 7; }, 0,
+                                    [](int, int) { return 0; }));
+}
+
+TEST(ParallelAlgorithmsTest, reduceByMutation)
+{
+    QVector<int> testContainer;
+    for (int i = 0; i < 100000; ++i)
+        testContainer << i % 1000;
+    auto policy = algorithms::par.withThreshold(0).withGrainSize(1000);
+    QHash<int, long long> counts = algorithms::reduceByMutation(policy, testContainer,
+                                                                [](QHash<int, long long> &acc, int x) { ++acc[x]; },
+                                                                QHash<int, long long>(),
+                                                                [](QHash<int, long long> &left, QHash<int, long long> &&right) {
+                                                                    for (auto it = right.cbegin(); it != right.cend(); ++it)
+                                                                        left[it.key()] += it.value();
+                                                                });
+    ASSERT_EQ(1000, counts.size());
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(100ll, counts[i]) << i;
+
+    QMap<int, int> mapContainer;
+    for (int i = 0; i < 100; ++i)
+        mapContainer[i] = i;
+    EXPECT_EQ(99 * 100 / 2, algorithms::reduceByMutation(policy, mapContainer,
+                                                         [](int &acc, int, int value) { acc += value; }, 0,
+                                                         [](int &left, int &&right) { left += right; }));
+}
@@ -300,6 +300,54 @@ TEST(AlgorithmsTest, makeUniqueVector)
     EXPECT_EQ(1, result[5]);
 }
 
+TEST(AlgorithmsTest, makeDistinct)
+{
+    QList<int> emptyContainer;
+    QList<int> qList = {1, 1, 2, 1, 3, 3, 3, 4, 1};
+    QVector<QString> qVector = {"b", "a", "b", "c", "a", "d"};
+    std::vector<int> stdVector;
+    for (int i = 0; i < 10000; ++i)
+        stdVector.push_back((i * 7919) % 1000);
+
+    algorithms::makeDistinct(emptyContainer);
+    EXPECT_EQ(0, emptyContainer.size());
+    algorithms::makeDistinct(qList);
+    EXPECT_EQ(QList<int>({1, 2, 3, 4}), qList);
+    algorithms::makeDistinct(qVector);
+    EXPECT_EQ(QVector<QString>({"b", "a", "c", "d"}), qVector);
+    algorithms::makeDistinct(stdVector);
+    ASSERT_EQ(1000u, stdVector.size());
+    for (size_t i = 0; i < stdVector.size(); ++i)
+        ASSERT_EQ(static_cast<int>((i * 7919) % 1000), stdVector[i]) << i;
+}
+
+struct DistinctPoint
+{
+    int x;
+    int y;
+    bool operator==(const DistinctPoint &other) const { return x == other.x && y == other.y; }
+};
+
+TEST(AlgorithmsTest, distinct)
+{
+    const QVector<int> testContainer = {5, 4, 5, 3, 4, 5, 1};
+    QVector<int> result = algorithms::distinct(testContainer);
+    EXPECT_EQ(QVector<int>({5, 4, 3, 1}), result);
+    EXPECT_EQ(7, testContainer.size());
+
+    // All points collide in hasher, equality still decides
+    std::vector<DistinctPoint> points = {{1, 2}, {2, 1}, {1, 2}, {0, 0}, {2, 1}};
+    auto hasher = [](const DistinctPoint &p) { return static_cast<size_t>(p.x + p.y); };
+    std::vector<DistinctPoint> distinctPoints = algorithms::distinct(points, hasher);
+    ASSERT_EQ(3u, distinctPoints.size());
+    EXPECT_EQ(1, distinctPoints[0].x);
+    EXPECT_EQ(2, distinctPoints[1].x);
+    EXPECT_EQ(0, distinctPoints[2].x);
+    algorithms::makeDistinct(points, hasher);
+    ASSERT_EQ(3u, points.size());
+    EXPECT_EQ(2, points[1].x);
+}
+
 TEST(AlgorithmsTest, existsQList)
 {
     QList<int> emptyContainer;
@@ -457,3 +505,24 @@ TEST(AlgorithmsTest, forAllSet)
     EXPECT_TRUE(algorithms::forAll(testContainer, truePredicate));
     EXPECT_FALSE(algorithms::forAll(testContainer, falsePredicate));
 }
+
+TEST(AlgorithmsTest, reduceByMutation)
+{
+    QVector<int> testContainer = {1, 2, 3, 2, 1, 2};
+    QMap<int, int> counts = algorithms::reduceByMutation(testContainer, [](QMap<int, int> &acc, int x) { ++acc[x]; },
+                                                         QMap<int, int>());
+    ASSERT_EQ(3, counts.size());
+    EXPECT_EQ(2, counts[1]);
+    EXPECT_EQ(3, counts[2]);
+    EXPECT_EQ(1, counts[3]);
+
+    QMap<int, bool> mapContainer = {{1, true}, {2, false}, {3, true}};
+    QVector<int> trueKeys = algorithms::reduceByMutation(mapContainer,
+                                                         [](QVector<int> &acc, int key, bool value) {
+                                                             if (value)
+                                                                 acc << key;
+                                                         },
+                                                         QVector<int>{0});
+    EXPECT_EQ(QVector<int>({0, 1, 3}), trueKeys);
+    EXPECT_EQ(5, algorithms::reduceByMutation(std::vector<int>(), [](int &acc, int x) { acc += x; }, 5));
+}
@@ -0,0 +1,131 @@
+// clazy:skip
+
+#include "proofseed/vectorizedalgorithms.h"
+
+#include "gtest/proof/test_global.h"
+
+#include <QList>
+#include <QVector>
+
+#include <vector>
+
+using namespace Proof;
+
+namespace {
+// Sizes cover empty, shorter than any vector register and unaligned tails
+const std::vector<int> SIZES = {0, 1, 3, 7, 8, 9, 31, 1000, 1027};
+
+template <typename Container>
+Container testData(int size)
+{
+    Container result;
+    for (int i = 0; i < size; ++i)
+        result.push_back(static_cast<typename Container::value_type>((i * 37) % 101) - 50);
+    return result;
+}
+} // namespace
+
+template <typename Container>
+class VectorizedAlgorithmsTest : public testing::Test
+{};
+
+using VectorizedContainers = testing::Types<QVector<double>, QVector<float>, QVector<int>, std::vector<double>,
+                                            std::vector<float>, std::vector<int>>;
+TYPED_TEST_SUITE(VectorizedAlgorithmsTest, VectorizedContainers);
+
+TYPED_TEST(VectorizedAlgorithmsTest, sum)
+{
+    using T = typename TypeParam::value_type;
+    for (int size : SIZES) {
+        TypeParam container = testData<TypeParam>(size);
+        T expected = 1;
+        for (T x : container)
+            expected += x;
+        // All values are integers, so no rounding differences here
+        EXPECT_EQ(expected, algorithms::reduce(container, algorithms::ops::Plus(), T(1))) << size;
+    }
+}
+
+TYPED_TEST(VectorizedAlgorithmsTest, minMax)
+{
+    using T = typename TypeParam::value_type;
+    for (int size : SIZES) {
+        TypeParam container = testData<TypeParam>(size);
+        T expectedMin = 20;
+        T expectedMax = -20;
+        for (T x : container) {
+            expectedMin = qMin(expectedMin, x);
+            expectedMax = qMax(expectedMax, x);
+        }
+        EXPECT_EQ(expectedMin, algorithms::reduce(container, algorithms::ops::Min(), T(20))) << size;
+        EXPECT_EQ(expectedMax, algorithms::reduce(container, algorithms::ops::Max(), T(-20))) << size;
+    }
+}
+
+TYPED_TEST(VectorizedAlgorithmsTest, scale)
+{
+    using T = typename TypeParam::value_type;
+    for (int size : SIZES) {
+        TypeParam container = testData<TypeParam>(size);
+        TypeParam result = algorithms::map(container, algorithms::ops::Scale<T>{T(1.5), T(-2)});
+        ASSERT_EQ(container.size(), result.size()) << size;
+        for (int i = 0; i < size; ++i)
+            EXPECT_EQ(container[i] * T(1.5) + T(-2), result[i]) << size << " " << i;
+    }
+}
+
+TYPED_TEST(VectorizedAlgorithmsTest, filter)
+{
+    using T = typename TypeParam::value_type;
+    for (int size : SIZES) {
+        TypeParam container = testData<TypeParam>(size);
+        TypeParam greater;
+        TypeParam lessOrEqual;
+        for (T x : container)
+            (x > T(10) ? greater : lessOrEqual).push_back(x);
+        EXPECT_EQ(greater, algorithms::filter(container, algorithms::ops::Greater<T>{T(10)})) << size;
+        EXPECT_EQ(lessOrEqual, algorithms::filter(container, algorithms::ops::LessOrEqual<T>{T(10)})) << size;
+        EXPECT_EQ(container, algorithms::filter(container, algorithms::ops::GreaterOrEqual<T>{T(-50)})) << size;
+        EXPECT_EQ(TypeParam(), algorithms::filter(container, algorithms::ops::Less<T>{T(-50)})) << size;
+    }
+}
+
+TYPED_TEST(VectorizedAlgorithmsTest, exists)
+{
+    using T = typename TypeParam::value_type;
+    for (int size : SIZES) {
+        TypeParam container = testData<TypeParam>(size);
+        container.push_back(T(100));
+        EXPECT_TRUE(algorithms::exists(container, algorithms::ops::Greater<T>{T(99)})) << size;
+        EXPECT_TRUE(algorithms::exists(container, algorithms::ops::GreaterOrEqual<T>{T(100)})) << size;
+        EXPECT_FALSE(algorithms::exists(container, algorithms::ops::Greater<T>{T(100)})) << size;
+        EXPECT_FALSE(algorithms::exists(container, algorithms::ops::Less<T>{T(-50)})) << size;
+        EXPECT_EQ(size > 0, algorithms::exists(container, algorithms::ops::LessOrEqual<T>{T(-50)})) << size;
+    }
+}
+
+TEST(VectorizedAlgorithmsTest, intScale)
+{
+    for (int size : SIZES) {
+        QVector<int> container = testData<QVector<int>>(size);
+        for (int i = 0; i < size; i += 3)
+            container[i] *= 1000000;
+        QVector<int> result = algorithms::map(container, algorithms::ops::Scale<int>{-3, 7});
+        ASSERT_EQ(container.size(), result.size()) << size;
+        for (int i = 0; i < size; ++i)
+            EXPECT_EQ(container[i] * -3 + 7, result[i]) << size << " " << i;
+    }
+}
+
+TEST(VectorizedAlgorithmsTest, nonVectorizableFallback)
+{
+    QList<double> list = {3.0, 1.0, 2.0};
+    QVector<qint64> longs = {3, 1, 2};
+    EXPECT_DOUBLE_EQ(6.0, algorithms::reduce(list, algorithms::ops::Plus(), 0.0));
+    EXPECT_EQ(1, algorithms::reduce(longs, algorithms::ops::Min(), qint64(10)));
+    EXPECT_EQ(QVector<qint64>({3, 2}), algorithms::filter(longs, algorithms::ops::Greater<qint64>{1}));
+    EXPECT_TRUE(algorithms::exists(longs, algorithms::ops::Less<qint64>{2}));
+    EXPECT_EQ(QVector<qint64>({7, 3, 5}), algorithms::map(longs, algorithms::ops::Scale<qint64>{2, 1}));
+    // Accumulator of other type goes to generic reduce
+    EXPECT_EQ(6, algorithms::reduce(QVector<double>({1.0, 2.0, 3.0}), algorithms::ops::Plus(), 0));
+}
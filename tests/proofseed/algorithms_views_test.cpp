@@ -0,0 +1,100 @@
+// clazy:skip
+
+#include "proofseed/algorithmviews.h"
+
+#include "gtest/proof/test_global.h"
+
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include <vector>
+
+using namespace Proof;
+
+TEST(AlgorithmViewsTest, filterMapToContainer)
+{
+    QVector<int> testContainer;
+    for (int i = 0; i < 1000; ++i)
+        testContainer << i;
+    auto isEven = [](int x) { return !(x % 2); };
+    auto toString = [](int x) { return QString::number(x % 100); };
+
+    QSet<QString> result = algorithms::from(testContainer) | algorithms::filtered(isEven) | algorithms::mapped(toString)
+                           | algorithms::to<QSet>();
+    EXPECT_EQ(algorithms::toSet(algorithms::map(algorithms::filter(testContainer, isEven), toString)), result);
+    ASSERT_EQ(50, result.size());
+
+    std::vector<long long> vectorResult = algorithms::from(testContainer) | algorithms::mapped([](int x) { return x * 3ll; })
+                                          | algorithms::filtered([](long long x) { return x > 2900; })
+                                          | algorithms::to<std::vector>();
+    ASSERT_EQ(33u, vectorResult.size());
+    for (size_t i = 0; i < vectorResult.size(); ++i)
+        EXPECT_EQ(2901ll + 3ll * static_cast<long long>(i), vectorResult[i]) << i;
+}
+
+TEST(AlgorithmViewsTest, singlePass)
+{
+    QVector<int> testContainer = {1, 2, 3, 4, 5, 6};
+    QVector<QString> calls;
+    QVector<int> result = algorithms::from(testContainer) | algorithms::filtered([&calls](int x) {
+                              calls << QStringLiteral("filter %1").arg(x);
+                              return x % 3;
+                          })
+                          | algorithms::mapped([&calls](int x) {
+                                calls << QStringLiteral("map %1").arg(x);
+                                return x * 10;
+                            })
+                          | algorithms::to<QVector>();
+    EXPECT_EQ(QVector<int>({10, 20, 40, 50}), result);
+    QVector<QString> expectedCalls = {"filter 1", "map 1", "filter 2", "map 2", "filter 3",
+                                      "filter 4", "map 4", "filter 5", "map 5", "filter 6"};
+    EXPECT_EQ(expectedCalls, calls);
+}
+
+TEST(AlgorithmViewsTest, reserveIfSizeIsKnown)
+{
+    std::vector<int> testContainer(1000, 2);
+    std::vector<int> mappedResult = algorithms::from(testContainer) | algorithms::mapped([](int x) { return x + 1; })
+                                    | algorithms::to<std::vector>();
+    ASSERT_EQ(1000u, mappedResult.size());
+    EXPECT_EQ(1000u, mappedResult.capacity());
+    EXPECT_EQ(std::vector<int>(1000, 3), mappedResult);
+
+    std::vector<int> filteredResult = algorithms::from(testContainer) | algorithms::filtered([](int x) { return x > 2; })
+                                      | algorithms::to<std::vector>();
+    EXPECT_TRUE(filteredResult.empty());
+}
+
+TEST(AlgorithmViewsTest, rvalueSource)
+{
+    auto makeContainer = []() {
+        QVector<int> result;
+        for (int i = 0; i < 100; ++i)
+            result << i;
+        return result;
+    };
+    auto view = algorithms::from(makeContainer()) | algorithms::filtered([](int x) { return x >= 90; });
+    QVector<int> first = view | algorithms::to<QVector>();
+    QVector<int> second = view | algorithms::mapped([](int x) { return x - 90; }) | algorithms::to<QVector>();
+    EXPECT_EQ(QVector<int>({90, 91, 92, 93, 94, 95, 96, 97, 98, 99}), first);
+    EXPECT_EQ(QVector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), second);
+}
+
+TEST(AlgorithmViewsTest, intoAndReduced)
+{
+    QMap<int, QString> testContainer;
+    for (int i = 0; i < 10; ++i)
+        testContainer[i] = QString::number(i * 2);
+    auto view = algorithms::from(testContainer) | algorithms::mapped([](const QString &x) { return x.toInt(); });
+
+    QMap<int, int> indexed = view | algorithms::filtered([](int x) { return x > 10; })
+                             | algorithms::mapped([](int x) { return qMakePair(x / 2, x); })
+                             | algorithms::into(QMap<int, int>{{0, 0}});
+    QMap<int, int> expected = {{0, 0}, {6, 12}, {7, 14}, {8, 16}, {9, 18}};
+    EXPECT_EQ(expected, indexed);
+
+    EXPECT_EQ(90ll, view | algorithms::reduced([](long long acc, int x) { return acc + x; }, 0ll));
+    EXPECT_EQ(0ll, algorithms::from(QVector<int>()) | algorithms::reduced([](long long acc, int x) { return acc + x; }, 0ll));
+}
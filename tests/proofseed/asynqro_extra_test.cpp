@@ -5,9 +5,16 @@
 #include "gtest/proof/test_global.h"
 
 #include <QDateTime>
+#include <QList>
 #include <QPair>
+#include <QSharedPointer>
 #include <QThread>
 #include <QTimer>
+#include <QVector>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
 
 using namespace Proof;
 using namespace Proof::repeater;
@@ -47,6 +54,32 @@ TEST(AsynqroExtraTest, failureWithData)
     EXPECT_EQ(QVariant("other"), another.data);
 }
 
+TEST(AsynqroExtraTest, failureWithChain)
+{
+    Failure failure = Failure("message", 10, 42, Failure::Hints::UserFriendlyHint, "data")
+                          .withMessage("changed")
+                          .withCode(11, 21)
+                          .withData("other");
+    EXPECT_TRUE(failure.exists);
+    EXPECT_EQ("changed", failure.message);
+    EXPECT_EQ(11, failure.moduleCode);
+    EXPECT_EQ(21, failure.errorCode);
+    EXPECT_EQ(Failure::Hints::UserFriendlyHint, failure.hints);
+    EXPECT_EQ(QVariant("other"), failure.data);
+}
+
+TEST(AsynqroExtraTest, failureWithKeepsOriginal)
+{
+    const Failure failure("message", 10, 42, Failure::Hints::UserFriendlyHint, "data");
+    Failure another = failure.withMessage("changed").withCode(11, 21);
+    EXPECT_EQ("changed", another.message);
+    EXPECT_EQ(11, another.moduleCode);
+    EXPECT_EQ("message", failure.message);
+    EXPECT_EQ(10, failure.moduleCode);
+    EXPECT_EQ(42, failure.errorCode);
+    EXPECT_EQ(QVariant("data"), failure.data);
+}
+
 TEST(AsynqroExtraTest, failureFromString)
 {
     Failure failure = asynqro::failure::failureFromString<Failure>("Message");
@@ -164,6 +197,69 @@ TEST(AsynqroExtraTest, futuresSequenceWithFailuresQMapLValue)
     ASSERT_EQ(0, f.resultRef().second.size());
 }
 
+TEST(AsynqroExtraTest, futuresSequenceShared)
+{
+    std::vector<Promise<int>> promises(5);
+    auto v = QSharedPointer<std::vector<Future<int>>>::create();
+    for (const auto &promise : promises)
+        v->push_back(promise.future());
+    Future<std::vector<int>> f = futures::sequence(v);
+    v.reset();
+    for (size_t i = 0; i < promises.size(); ++i) {
+        ASSERT_FALSE(f.isCompleted());
+        promises[i].success(static_cast<int>(i) * 5);
+    }
+    ASSERT_TRUE(f.isCompleted());
+    ASSERT_TRUE(f.isSucceeded());
+    ASSERT_EQ(5, f.resultRef().size());
+    for (unsigned i = 0; i < 5; ++i)
+        EXPECT_EQ(5 * i, f.resultRef()[i]) << i;
+}
+
+TEST(AsynqroExtraTest, futuresSequenceSharedCompleted)
+{
+    auto v = QSharedPointer<std::vector<Future<int>>>::create();
+    for (int i = 0; i < 5; ++i)
+        v->push_back(futures::successful(i * 5));
+    Future<std::vector<int>> f = futures::sequence(v);
+    ASSERT_TRUE(f.isCompleted());
+    ASSERT_TRUE(f.isSucceeded());
+    ASSERT_EQ(5, f.resultRef().size());
+    for (unsigned i = 0; i < 5; ++i)
+        EXPECT_EQ(5 * i, f.resultRef()[i]) << i;
+}
+
+TEST(AsynqroExtraTest, futuresSequenceSharedFailure)
+{
+    auto v = QSharedPointer<const QVector<Future<int>>>::create(
+        QVector<Future<int>>{futures::successful(0), Future<int>::failed(Failure("failed", 1, 2)),
+                             futures::successful(10)});
+    Future<QVector<int>> f = futures::sequence(v);
+    ASSERT_TRUE(f.isCompleted());
+    ASSERT_TRUE(f.isFailed());
+    EXPECT_EQ("failed", f.failureReason().message);
+    EXPECT_EQ(2, f.failureReason().errorCode);
+
+    Future<QVector<int>> empty = futures::sequence(QSharedPointer<QVector<Future<int>>>::create());
+    ASSERT_TRUE(empty.isCompleted());
+    ASSERT_TRUE(empty.isSucceeded());
+    EXPECT_EQ(0, empty.resultRef().size());
+}
+
+TEST(AsynqroExtraTest, futuresSequenceWithFailuresShared)
+{
+    auto v = QSharedPointer<std::vector<Future<int>>>::create(std::vector<Future<int>>{
+        futures::successful(0), Future<int>::failed(Failure("failed", 1, 2)), futures::successful(10)});
+    auto f = futures::sequenceWithFailures(v);
+    ASSERT_TRUE(f.isCompleted());
+    ASSERT_TRUE(f.isSucceeded());
+    ASSERT_EQ(2, f.resultRef().first.size());
+    EXPECT_EQ(0, f.resultRef().first[0]);
+    EXPECT_EQ(10, f.resultRef().first[2]);
+    ASSERT_EQ(1, f.resultRef().second.size());
+    EXPECT_EQ("failed", f.resultRef().second[1].message);
+}
+
 TEST(AsynqroExtraTest, repeatData)
 {
     Future<std::vector<int>> f = futures::repeat<std::vector<int>>(
@@ -181,6 +277,99 @@ TEST(AsynqroExtraTest, repeatData)
         EXPECT_EQ(i, f.resultRef()[i]);
 }
 
+TEST(AsynqroExtraTest, loopCompleted)
+{
+    futures::Loop<long long> loop = futures::loop<long long>(
+        [](int step, long long sum) -> RepeaterResult<long long, int, long long> {
+            if (step >= 1000000)
+                return Finish(sum);
+            if (step % 2)
+                return TrampolinedContinue(step + 1, sum + step);
+            return Continue(step + 1, sum + step);
+        },
+        0, 0ll);
+    Future<long long> f = loop;
+    ASSERT_TRUE(f.isCompleted());
+    ASSERT_TRUE(f.isSucceeded());
+    EXPECT_EQ(999999ll * 1000000ll / 2, f.result());
+    futures::LoopStats stats = loop.stats();
+    EXPECT_TRUE(stats.finished);
+    EXPECT_EQ(1000001, stats.iterations);
+    EXPECT_EQ(0, stats.suspensions);
+    EXPECT_EQ(stats.timeInLoop, loop.stats().timeInLoop);
+}
+
+TEST(AsynqroExtraTest, loopPending)
+{
+    using Step = RepeaterResult<std::vector<int>, int, std::vector<int>>;
+    std::vector<Promise<Step>> promises(10);
+    futures::Loop<std::vector<int>> loop = futures::loop<std::vector<int>>(
+        [&promises](int step, std::vector<int> order) -> RepeaterFutureResult<std::vector<int>, int, std::vector<int>> {
+            order.push_back(step);
+            if (step >= 99)
+                return futures::successful(Step(Finish(order)));
+            if (step % 10)
+                return futures::successful(Step(Continue(step + 1, std::move(order))));
+            promises[static_cast<size_t>(step / 10)].success(Continue(step + 1, std::move(order)));
+            return promises[static_cast<size_t>(step / 10)].future();
+        },
+        0, std::vector<int>{});
+    Future<std::vector<int>> f = loop.future();
+    ASSERT_TRUE(f.isCompleted());
+    ASSERT_TRUE(f.isSucceeded());
+    ASSERT_EQ(100u, f.resultRef().size());
+    for (size_t i = 0; i < f.resultRef().size(); ++i)
+        EXPECT_EQ(static_cast<int>(i), f.resultRef()[i]);
+    EXPECT_EQ(100, loop.stats().iterations);
+    EXPECT_EQ(0, loop.stats().suspensions);
+
+    Promise<RepeaterResult<int, int>> pending;
+    futures::Loop<int> pendingLoop = futures::loop<int>(
+        [pending](int step) -> RepeaterFutureResult<int, int> {
+            if (step == 5)
+                return pending.future();
+            if (step == 10)
+                return futures::successful(RepeaterResult<int, int>(Finish(step)));
+            return futures::successful(RepeaterResult<int, int>(Continue(step + 1)));
+        },
+        0);
+    EXPECT_FALSE(pendingLoop.future().isCompleted());
+    EXPECT_FALSE(pendingLoop.stats().finished);
+    EXPECT_EQ(6, pendingLoop.stats().iterations);
+    std::thread completer([pending]() { pending.success(Continue(6)); });
+    completer.join();
+    ASSERT_TRUE(pendingLoop.future().isSucceeded());
+    EXPECT_EQ(10, pendingLoop.future().result());
+    EXPECT_TRUE(pendingLoop.stats().finished);
+    EXPECT_EQ(11, pendingLoop.stats().iterations);
+    EXPECT_EQ(1, pendingLoop.stats().suspensions);
+}
+
+TEST(AsynqroExtraTest, loopFailure)
+{
+    Future<int> failed = futures::loop<int>(
+        [](int step) -> RepeaterFutureResult<int, int> {
+            if (step == 3)
+                return Future<RepeaterResult<int, int>>::failed(Failure("failed", 1, 2));
+            return futures::successful(RepeaterResult<int, int>(Continue(step + 1)));
+        },
+        0);
+    ASSERT_TRUE(failed.isCompleted());
+    ASSERT_TRUE(failed.isFailed());
+    EXPECT_EQ("failed", failed.failureReason().message);
+
+    Future<int> thrown = futures::loop<int>(
+        [](int step) -> RepeaterResult<int, int> {
+            if (step == 3)
+                throw std::runtime_error("thrown");
+            return Continue(step + 1);
+        },
+        0);
+    ASSERT_TRUE(thrown.isCompleted());
+    ASSERT_TRUE(thrown.isFailed());
+    EXPECT_EQ("Exception caught: thrown", thrown.failureReason().message);
+}
+
 TEST(AsynqroExtraTest, repeatForSequenceRValue)
 {
     std::vector<Promise<double>> promises(5);
@@ -246,3 +435,162 @@ TEST(AsynqroExtraTest, runAndForgetWrapper)
     ASSERT_TRUE(future.isSucceeded());
     ASSERT_NE(std::this_thread::get_id(), future.result());
 }
+
+TEST(AsynqroExtraTest, repeatForSequenceShared)
+{
+    std::vector<Promise<double>> promises(5);
+    auto data = QSharedPointer<const std::vector<size_t>>::create(std::vector<size_t>{0, 1, 2, 3, 4});
+    Future<std::vector<double>> f = futures::repeatForSequence(data, std::vector<double>{},
+                                                               [&promises](size_t x, std::vector<double> result) {
+                                                                   if (x == 2)
+                                                                       return futures::successful(result);
+                                                                   return promises[x].future().map([result](double x) {
+                                                                       auto newResult = result;
+                                                                       newResult.push_back(x);
+                                                                       return newResult;
+                                                                   });
+                                                               });
+    data.reset();
+    for (size_t i = 0; i < promises.size(); ++i) {
+        ASSERT_FALSE(f.isCompleted());
+        promises[i].success(i / 10.0);
+    }
+    ASSERT_TRUE(f.isCompleted());
+    ASSERT_TRUE(f.isSucceeded());
+    ASSERT_EQ(4, f.resultRef().size());
+    EXPECT_DOUBLE_EQ(0.0, f.resultRef()[0]);
+    EXPECT_DOUBLE_EQ(0.1, f.resultRef()[1]);
+    EXPECT_DOUBLE_EQ(0.3, f.resultRef()[2]);
+    EXPECT_DOUBLE_EQ(0.4, f.resultRef()[3]);
+}
+
+TEST(AsynqroExtraTest, repeatForSequenceSharedFailure)
+{
+    auto data = QSharedPointer<QList<int>>::create(QList<int>{1, 2, 3});
+    Future<int> f = futures::repeatForSequence(data, 0, [](int x, int sum) {
+        if (x == 2)
+            return Future<int>::failed(Failure("failed", 1, 2));
+        return futures::successful(sum + x);
+    });
+    ASSERT_TRUE(f.isCompleted());
+    ASSERT_TRUE(f.isFailed());
+    EXPECT_EQ("failed", f.failureReason().message);
+}
+
+TEST(AsynqroExtraTest, windowedRun)
+{
+    QVector<int> data;
+    for (int i = 0; i < 1000; ++i)
+        data << i;
+    std::atomic<int> inFlight{0};
+    std::atomic<int> maxInFlight{0};
+    Future<QVector<long long>> future = tasks::windowedRun(data,
+                                                           [&inFlight, &maxInFlight](int x) {
+                                                               int current = ++inFlight;
+                                                               int max = maxInFlight;
+                                                               while (current > max
+                                                                      && !maxInFlight.compare_exchange_weak(max, current))
+                                                                   ;
+                                                               std::this_thread::yield();
+                                                               --inFlight;
+                                                               return x * 2ll;
+                                                           },
+                                                           3);
+    ASSERT_TRUE(future.wait(10000));
+    ASSERT_TRUE(future.isSucceeded());
+    ASSERT_EQ(1000, future.resultRef().size());
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(i * 2ll, future.resultRef()[i]) << i;
+    EXPECT_GE(3, maxInFlight);
+}
+
+TEST(AsynqroExtraTest, windowedRunUnordered)
+{
+    std::vector<int> data;
+    for (int i = 0; i < 1000; ++i)
+        data.push_back(i);
+    Future<std::vector<int>> future = tasks::windowedRun(data, [](int x) { return x + 1; }, 4,
+                                                         tasks::WindowOrder::Unordered);
+    ASSERT_TRUE(future.wait(10000));
+    ASSERT_TRUE(future.isSucceeded());
+    std::vector<int> result = future.result();
+    ASSERT_EQ(1000, result.size());
+    std::sort(result.begin(), result.end());
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(i + 1, result[static_cast<size_t>(i)]) << i;
+}
+
+TEST(AsynqroExtraTest, windowedRunWithFutures)
+{
+    std::vector<Promise<int>> promises(10);
+    std::atomic<int> started{0};
+    Future<QList<int>> future = tasks::windowedRun(QList<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+                                                   [&promises, &started](int x) {
+                                                       ++started;
+                                                       return promises[static_cast<size_t>(x)].future();
+                                                   },
+                                                   2);
+    for (int i = 0; i < 10; ++i) {
+        while (started < qMin(i + 2, 10))
+            ;
+        EXPECT_EQ(qMin(i + 2, 10), started);
+        ASSERT_FALSE(future.isCompleted());
+        promises[static_cast<size_t>(i)].success(i * 3);
+    }
+    ASSERT_TRUE(future.wait(10000));
+    ASSERT_TRUE(future.isSucceeded());
+    ASSERT_EQ(10, future.resultRef().size());
+    for (int i = 0; i < 10; ++i)
+        EXPECT_EQ(i * 3, future.resultRef()[i]) << i;
+}
+
+TEST(AsynqroExtraTest, windowedRunOrderedWindow)
+{
+    std::vector<Promise<int>> promises(10);
+    std::atomic<int> started{0};
+    Future<QVector<int>> future = tasks::windowedRun(QVector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+                                                     [&promises, &started](int x) {
+                                                         ++started;
+                                                         return promises[static_cast<size_t>(x)].future();
+                                                     },
+                                                     3);
+    // Elements after the first one in window are done, but window moves only when the first one is done too
+    for (int first = 0; first < 9; first += 3) {
+        while (started < first + 3)
+            ;
+        promises[static_cast<size_t>(first + 2)].success(first + 2);
+        promises[static_cast<size_t>(first + 1)].success(first + 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(first + 3, started) << first;
+        ASSERT_FALSE(future.isCompleted());
+        promises[static_cast<size_t>(first)].success(first);
+    }
+    while (started < 10)
+        ;
+    ASSERT_FALSE(future.isCompleted());
+    promises[9].success(9);
+    ASSERT_TRUE(future.wait(10000));
+    ASSERT_TRUE(future.isSucceeded());
+    EXPECT_EQ(QVector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), future.result());
+}
+
+TEST(AsynqroExtraTest, windowedRunFailure)
+{
+    QVector<int> data;
+    for (int i = 0; i < 100; ++i)
+        data << i;
+    Future<QVector<int>> future = tasks::windowedRun(data,
+                                                     [](int x) {
+                                                         if (x == 50)
+                                                             throw std::runtime_error("failed");
+                                                         return x;
+                                                     },
+                                                     4);
+    ASSERT_TRUE(future.wait(10000));
+    ASSERT_TRUE(future.isFailed());
+    EXPECT_TRUE(future.failureReason().hints & Failure::FromExceptionHint);
+
+    Future<QVector<int>> empty = tasks::windowedRun(QVector<int>(), [](int x) { return x; }, 4);
+    ASSERT_TRUE(empty.isCompleted());
+    EXPECT_TRUE(empty.isSucceeded());
+}
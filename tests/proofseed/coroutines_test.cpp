@@ -0,0 +1,143 @@
+// clazy:skip
+
+#include "proofseed/coroutines.h"
+
+#include "gtest/proof/test_global.h"
+
+#ifdef PROOF_SEED_COROUTINES_SUPPORTED
+
+#    include <QThread>
+
+#    include <atomic>
+#    include <stdexcept>
+#    include <thread>
+
+using namespace Proof;
+
+namespace {
+Task<int> addLater(Future<int> future, int addition)
+{
+    int value = co_await future;
+    co_return value + addition;
+}
+
+Task<int> failIfNegative(int x)
+{
+    if (x < 0)
+        throw std::runtime_error("negative");
+    co_return x;
+}
+
+Task<> sixSteps(Promise<int> input, std::atomic<int> *sum)
+{
+    Future<int> pending = input.future();
+    for (int i = 0; i < 5; ++i)
+        *sum += co_await futures::successful(i);
+    *sum += co_await pending;
+}
+} // namespace
+
+TEST(CoroutinesTest, awaitFuture)
+{
+    Promise<int> promise;
+    Future<int> result = addLater(promise.future(), 2);
+    EXPECT_FALSE(result.isCompleted());
+    std::thread completer([promise]() mutable { promise.success(40); });
+    completer.join();
+    result.wait(1000);
+    ASSERT_TRUE(result.isSucceeded());
+    EXPECT_EQ(42, result.result());
+
+    Future<int> ready = addLater(futures::successful(1), 1);
+    ready.wait(1000);
+    ASSERT_TRUE(ready.isSucceeded());
+    EXPECT_EQ(2, ready.result());
+}
+
+TEST(CoroutinesTest, failures)
+{
+    Promise<int> promise;
+    Future<int> awaitedFailure = addLater(promise.future(), 2);
+    promise.failure(Failure(QStringLiteral("failed"), 1, 2));
+    awaitedFailure.wait(1000);
+    ASSERT_TRUE(awaitedFailure.isFailed());
+    EXPECT_EQ("failed", awaitedFailure.failureReason().message);
+    EXPECT_EQ(1, awaitedFailure.failureReason().moduleCode);
+    EXPECT_EQ(2, awaitedFailure.failureReason().errorCode);
+
+    Future<int> thrown = failIfNegative(-1).future();
+    thrown.wait(1000);
+    ASSERT_TRUE(thrown.isFailed());
+    EXPECT_EQ("Exception caught: negative", thrown.failureReason().message);
+}
+
+TEST(CoroutinesTest, awaitTask)
+{
+    auto outer = []() -> Task<int> {
+        int first = co_await failIfNegative(20);
+        int second = co_await addLater(futures::successful(first), 2);
+        try {
+            co_await failIfNegative(-1);
+        } catch (const std::exception &) {
+            co_return -1;
+        }
+        co_return second;
+    };
+    Future<int> result = outer();
+    result.wait(1000);
+    // Failure of awaited task is not std::exception and finishes outer coroutine as well
+    ASSERT_TRUE(result.isFailed());
+    EXPECT_EQ("Exception caught: negative", result.failureReason().message);
+}
+
+TEST(CoroutinesTest, schedule)
+{
+    std::thread::id caller = std::this_thread::get_id();
+    std::atomic<bool> startedInCaller{true};
+    std::atomic<bool> resumedInCaller{true};
+    auto coroutine = [&]() -> Task<> {
+        startedInCaller = std::this_thread::get_id() == caller;
+        co_await tasks::schedule(tasks::TaskType::Intensive);
+        resumedInCaller = std::this_thread::get_id() == caller;
+    };
+    Future<bool> result = coroutine();
+    result.wait(1000);
+    ASSERT_TRUE(result.isSucceeded());
+    EXPECT_TRUE(result.result());
+    EXPECT_FALSE(startedInCaller);
+    EXPECT_FALSE(resumedInCaller);
+
+    Promise<int> promise;
+    std::atomic<bool> resumedInCompleter{true};
+    std::thread::id completerId;
+    auto resumer = [&]() -> Task<int> {
+        int value = co_await tasks::resumeOn(promise.future(), tasks::TaskType::Intensive);
+        resumedInCompleter = std::this_thread::get_id() == completerId;
+        co_return value;
+    };
+    Future<int> resumed = resumer();
+    std::thread completer([&promise, &completerId]() {
+        completerId = std::this_thread::get_id();
+        promise.success(5);
+    });
+    completer.join();
+    resumed.wait(1000);
+    ASSERT_TRUE(resumed.isSucceeded());
+    EXPECT_EQ(5, resumed.result());
+    EXPECT_FALSE(resumedInCompleter);
+}
+
+TEST(CoroutinesTest, singleAllocationPerFlow)
+{
+    Promise<int> input;
+    std::atomic<int> sum{0};
+    MemoryPoolStats before = MemoryPool::stats();
+    Future<bool> result = sixSteps(input, &sum);
+    MemoryPoolStats after = MemoryPool::stats();
+    EXPECT_EQ(before.hits + before.misses + before.oversized + 1, after.hits + after.misses + after.oversized);
+    input.success(5);
+    result.wait(1000);
+    ASSERT_TRUE(result.isSucceeded());
+    EXPECT_EQ(15, sum);
+}
+#endif
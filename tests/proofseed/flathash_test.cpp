@@ -0,0 +1,220 @@
+// clazy:skip
+
+#include "proofseed/flathash.h"
+#include "proofseed/parallelalgorithms.h"
+
+#include "gtest/proof/test_global.h"
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace Proof;
+
+namespace {
+// All values are in the same group, so probing and deleted slots are exercised
+struct CollidingHasher
+{
+    size_t operator()(int) const { return 42; }
+};
+} // namespace
+
+TEST(FlatHashTest, setInsertFindRemove)
+{
+    FlatHashSet<int> set;
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_FALSE(set.contains(5));
+    EXPECT_EQ(set.end(), set.find(5));
+    EXPECT_EQ(0, set.capacity());
+
+    for (int i = 0; i < 10000; ++i)
+        set.insert(i * 7);
+    set.insert(7);
+    ASSERT_EQ(10000, set.size());
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_TRUE(set.contains(i * 7)) << i;
+        ASSERT_FALSE(set.contains(i * 7 + 1)) << i;
+    }
+
+    for (int i = 0; i < 10000; i += 2)
+        EXPECT_TRUE(set.remove(i * 7)) << i;
+    EXPECT_FALSE(set.remove(0));
+    ASSERT_EQ(5000, set.size());
+    long long iterated = 0;
+    for (int x : set) {
+        EXPECT_EQ(7, (x / 7) % 2 * 7) << x;
+        ++iterated;
+    }
+    EXPECT_EQ(5000, iterated);
+
+    for (auto it = set.begin(); it != set.end();)
+        it = *it % 3 ? set.erase(it) : std::next(it);
+    for (int x : set)
+        EXPECT_EQ(0, x % 3) << x;
+
+    set.clear();
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_EQ(set.begin(), set.end());
+    set.squeeze();
+    EXPECT_EQ(0, set.capacity());
+}
+
+TEST(FlatHashTest, setCollisionsAndReuse)
+{
+    FlatHashSet<int, CollidingHasher> set;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 100; ++i)
+            set.insert(i);
+        ASSERT_EQ(100, set.size()) << round;
+        for (int i = 0; i < 100; ++i)
+            ASSERT_TRUE(set.contains(i)) << round << i;
+        for (int i = 0; i < 100; i += 3)
+            set.remove(i);
+        for (int i = 0; i < 100; ++i)
+            ASSERT_EQ(i % 3 != 0, set.contains(i)) << round << i;
+    }
+    // Deleted slots are cleaned up instead of growing table
+    EXPECT_GE(256, set.capacity());
+}
+
+TEST(FlatHashTest, setCopyMoveAndReserve)
+{
+    FlatHashSet<QString> set = {"a", "b", "c"};
+    set.reserve(1000);
+    const long long capacity = set.capacity();
+    EXPECT_LE(1000, capacity);
+    for (int i = 0; i < 1000; ++i)
+        set.insert(QString::number(i));
+    EXPECT_EQ(capacity, set.capacity());
+    EXPECT_EQ(1003, set.size());
+
+    FlatHashSet<QString> copy = set;
+    EXPECT_EQ(set, copy);
+    copy.remove("a");
+    EXPECT_NE(set, copy);
+    EXPECT_TRUE(set.contains("a"));
+
+    FlatHashSet<QString> moved = std::move(copy);
+    EXPECT_EQ(1002, moved.size());
+    EXPECT_TRUE(moved.contains("999"));
+    EXPECT_FALSE(moved.contains("a"));
+    moved.squeeze();
+    EXPECT_GT(capacity, moved.capacity() / 2);
+    EXPECT_TRUE(moved.contains("b"));
+}
+
+TEST(FlatHashTest, elementsLifetime)
+{
+    auto counter = std::make_shared<int>(5);
+    {
+        FlatHashMap<int, std::shared_ptr<int>> map;
+        for (int i = 0; i < 1000; ++i)
+            map.insert(i, counter);
+        for (int i = 0; i < 1000; i += 2)
+            map.remove(i);
+        EXPECT_EQ(501, counter.use_count());
+        FlatHashMap<int, std::shared_ptr<int>> copy = map;
+        EXPECT_EQ(1001, counter.use_count());
+        copy.clear();
+        EXPECT_EQ(501, counter.use_count());
+        EXPECT_EQ(counter, map.take(1));
+        EXPECT_EQ(500, counter.use_count());
+    }
+    EXPECT_EQ(1, counter.use_count());
+}
+
+TEST(FlatHashTest, map)
+{
+    FlatHashMap<QString, int> map;
+    for (int i = 0; i < 1000; ++i)
+        map.insert(QString::number(i), i);
+    map.insert("5", 50);
+    ++map["6"];
+    map["new"] = 42;
+    ASSERT_EQ(1001, map.size());
+    EXPECT_EQ(50, map.value("5"));
+    EXPECT_EQ(7, map.value("6"));
+    EXPECT_EQ(42, map.value("new"));
+    EXPECT_EQ(-1, map.value("absent", -1));
+    EXPECT_FALSE(map.contains("absent"));
+
+    const auto &constMap = map;
+    auto it = constMap.find("10");
+    ASSERT_NE(constMap.end(), it);
+    EXPECT_EQ("10", it.key());
+    EXPECT_EQ(10, *it);
+    EXPECT_EQ(0, constMap["absent"]);
+    EXPECT_FALSE(map.contains("absent"));
+
+    long long sum = 0;
+    for (auto mapIt = map.begin(); mapIt != map.end(); ++mapIt) {
+        if (mapIt.key() != "5" && mapIt.key() != "6" && mapIt.key() != "new") {
+            EXPECT_EQ(mapIt.key().toInt(), mapIt.value());
+        }
+        sum += *mapIt;
+    }
+    EXPECT_EQ(999 * 1000 / 2 + 45 + 1 + 42, sum);
+
+    map.erase(map.find("new"));
+    EXPECT_FALSE(map.contains("new"));
+    EXPECT_EQ(1000, map.size());
+}
+
+TEST(FlatHashTest, insertFromOwnElements)
+{
+    FlatHashMap<int, std::string> map;
+    map.insert(0, std::string(100, 'x'));
+    for (int i = 1; i < 200; ++i)
+        map.insert(i, *map.find(0));
+    for (int i = 0; i < 200; ++i)
+        ASSERT_EQ(std::string(100, 'x'), map.value(i)) << i;
+
+    FlatHashMap<std::string, int> keys;
+    keys.insert(std::string(100, 'a'), 0);
+    for (int i = 1; i < 200; ++i) {
+        const std::string &previous = keys.find(std::string(i + 99, 'a')).key();
+        keys[previous + "a"] = i;
+    }
+    for (int i = 0; i < 200; ++i)
+        ASSERT_EQ(i, keys.value(std::string(i + 100, 'a'), -1)) << i;
+
+    FlatHashSet<std::string> set;
+    set.insert(std::string(100, 'y'));
+    for (int i = 1; i < 200; ++i)
+        set.insert(*set.begin() + std::to_string(i));
+    EXPECT_EQ(200, set.size());
+}
+
+TEST(FlatHashTest, algorithms)
+{
+    QVector<int> vector;
+    QHash<int, QString> hash;
+    std::map<int, QString> stdMap;
+    for (int i = 0; i < 5000; ++i) {
+        vector << i % 1000;
+        hash[i] = QString::number(i % 10);
+        stdMap[i] = QString::number(i % 10);
+    }
+
+    FlatHashSet<int> set = algorithms::toFlatSet(vector);
+    EXPECT_EQ(1000, set.size());
+    EXPECT_EQ(algorithms::toSet(vector), algorithms::toSet(set));
+    EXPECT_EQ(set, algorithms::map(algorithms::par.withThreshold(0).withGrainSize(100), vector, algorithms::identity(),
+                                   FlatHashSet<int>()));
+    EXPECT_EQ(100, algorithms::filter(set, [](int x) { return x % 10 == 0; }).size());
+
+    FlatHashSet<int> keys = algorithms::toFlatKeysSet(hash);
+    EXPECT_EQ(5000, keys.size());
+    EXPECT_EQ(algorithms::toKeysSet(hash), algorithms::toSet(keys));
+
+    FlatHashMap<int, QString> map = algorithms::toFlatMap(hash);
+    EXPECT_EQ(map, algorithms::toFlatMap(stdMap));
+    EXPECT_EQ(algorithms::toKeysSet(hash), algorithms::toKeysSet(map));
+    EXPECT_EQ(algorithms::toValuesSet(hash), algorithms::toValuesSet(map));
+    EXPECT_EQ(10, algorithms::toValuesSet(algorithms::par.withThreshold(0).withGrainSize(100), map).size());
+}
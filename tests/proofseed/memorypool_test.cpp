@@ -0,0 +1,133 @@
+// clazy:skip
+
+#include "proofseed/memorypool.h"
+
+#include "gtest/proof/test_global.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace Proof;
+
+namespace {
+struct PooledPoint : Pooled
+{
+    PooledPoint(int x, int y) : x(x), y(y) {}
+    int x;
+    int y;
+};
+} // namespace
+
+TEST(MemoryPoolTest, blocksReuse)
+{
+    for (size_t size : {1, 16, 17, 100, 256, 500, 512}) {
+        void *first = MemoryPool::allocate(size);
+        ASSERT_NE(nullptr, first) << size;
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(first) % alignof(std::max_align_t)) << size;
+        std::memset(first, 0xAB, size);
+        MemoryPool::deallocate(first, size);
+        MemoryPoolStats before = MemoryPool::stats();
+        void *second = MemoryPool::allocate(size);
+        EXPECT_EQ(first, second) << size;
+        MemoryPoolStats after = MemoryPool::stats();
+        EXPECT_EQ(before.hits + 1, after.hits) << size;
+        EXPECT_EQ(before.misses, after.misses) << size;
+        MemoryPool::deallocate(second, size);
+    }
+}
+
+TEST(MemoryPoolTest, distinctBlocks)
+{
+    std::vector<void *> blocks;
+    std::set<void *> unique;
+    for (int i = 0; i < 10000; ++i) {
+        void *block = MemoryPool::allocate(48);
+        std::memset(block, i % 256, 48);
+        blocks.push_back(block);
+        unique.insert(block);
+    }
+    EXPECT_EQ(blocks.size(), unique.size());
+    EXPECT_GE(MemoryPool::stats().reservedBytes, 10000ull * 64);
+    for (void *block : blocks)
+        MemoryPool::deallocate(block, 48);
+}
+
+TEST(MemoryPoolTest, oversized)
+{
+    MemoryPoolStats before = MemoryPool::stats();
+    void *block = MemoryPool::allocate(MemoryPool::MAX_BLOCK_SIZE + 1);
+    std::memset(block, 0, MemoryPool::MAX_BLOCK_SIZE + 1);
+    MemoryPool::deallocate(block, MemoryPool::MAX_BLOCK_SIZE + 1);
+    MemoryPoolStats after = MemoryPool::stats();
+    EXPECT_EQ(before.oversized + 1, after.oversized);
+    EXPECT_EQ(before.hits, after.hits);
+    EXPECT_EQ(before.misses, after.misses);
+}
+
+TEST(MemoryPoolTest, allocators)
+{
+    std::vector<int, PoolAllocator<int>> vector;
+    for (int i = 0; i < 1000; ++i)
+        vector.push_back(i);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(i, vector[static_cast<size_t>(i)]);
+
+    std::shared_ptr<std::vector<int>> shared = makePooledShared<std::vector<int>>(5, 42);
+    ASSERT_EQ(5u, shared->size());
+    EXPECT_EQ(42, shared->front());
+    std::weak_ptr<std::vector<int>> weak = shared;
+    shared.reset();
+    EXPECT_TRUE(weak.expired());
+
+    std::unique_ptr<PooledPoint> point(new PooledPoint(3, 4));
+    EXPECT_EQ(3, point->x);
+    EXPECT_EQ(4, point->y);
+}
+
+TEST(MemoryPoolTest, crossThreadDeallocation)
+{
+    constexpr int PRODUCERS = 4;
+    constexpr int BLOCKS = 20000;
+    std::vector<std::vector<void *>> produced(PRODUCERS);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < PRODUCERS; ++i) {
+        threads.emplace_back([&produced, i]() {
+            for (int j = 0; j < BLOCKS; ++j) {
+                auto *block = static_cast<int *>(MemoryPool::allocate(sizeof(int) * 8));
+                block[0] = i;
+                block[7] = j;
+                produced[static_cast<size_t>(i)].push_back(block);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+
+    std::atomic<long long> mismatches{0};
+    for (int i = 0; i < PRODUCERS; ++i) {
+        threads.emplace_back([&produced, &mismatches, i]() {
+            // Frees blocks of other thread and allocates new ones in between
+            const auto &blocks = produced[static_cast<size_t>((i + 1) % PRODUCERS)];
+            for (size_t j = 0; j < blocks.size(); ++j) {
+                auto *block = static_cast<int *>(blocks[j]);
+                if (block[0] != (i + 1) % PRODUCERS || block[7] != static_cast<int>(j))
+                    ++mismatches;
+                MemoryPool::deallocate(block, sizeof(int) * 8);
+                if (!(j % 3))
+                    MemoryPool::deallocate(MemoryPool::allocate(sizeof(int) * 8), sizeof(int) * 8);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    EXPECT_EQ(0, mismatches);
+
+    MemoryPoolStats stats = MemoryPool::stats();
+    EXPECT_GE(stats.hits + stats.misses, static_cast<quint64>(PRODUCERS * BLOCKS));
+}
@@ -0,0 +1,143 @@
+// clazy:skip
+
+#include "proofseed/pipeline.h"
+
+#include "gtest/proof/test_global.h"
+
+#include <QList>
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Proof;
+
+TEST(PipelineTest, singleWorkerStages)
+{
+    QVector<int> data;
+    for (int i = 0; i < 10000; ++i)
+        data << i;
+    std::vector<long long> result;
+    pipeline::Pipeline p = pipeline::from(data)
+                               .stage([](int x) { return x * 2ll; })
+                               .stage([](long long x) { return x + 1; })
+                               .sink([&result](long long x) { result.push_back(x); });
+    Future<long long> future = p.run();
+    ASSERT_TRUE(future.wait(10000));
+    ASSERT_TRUE(future.isSucceeded());
+    EXPECT_EQ(10000, future.result());
+    ASSERT_EQ(10000u, result.size());
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_EQ(i * 2ll + 1, result[static_cast<size_t>(i)]) << i;
+
+    QVector<pipeline::StageStats> stats = p.stats();
+    ASSERT_EQ(4, stats.size());
+    for (const auto &stage : stats) {
+        EXPECT_EQ(10000, stage.processed);
+        EXPECT_EQ(0, stage.queueDepth);
+        EXPECT_EQ(0, stage.activeWorkers);
+    }
+    EXPECT_EQ(128, stats[1].queueCapacity);
+    EXPECT_GE(128, stats[1].maxQueueDepth);
+}
+
+TEST(PipelineTest, multipleWorkers)
+{
+    std::vector<int> data;
+    for (int i = 0; i < 20000; ++i)
+        data.push_back(i);
+    std::atomic<long long> sum{0};
+    Future<long long> future = pipeline::from(data)
+                                   .stage([](int x) { return static_cast<long long>(x); }, 4)
+                                   .stage([](long long x) { return x * 3; }, 3, tasks::TaskType::Intensive, 16)
+                                   .sink([&sum](long long x) { sum += x; }, 2)
+                                   .run();
+    ASSERT_TRUE(future.wait(10000));
+    ASSERT_TRUE(future.isSucceeded());
+    EXPECT_EQ(20000, future.result());
+    EXPECT_EQ(19999ll * 20000ll / 2 * 3, sum);
+}
+
+TEST(PipelineTest, generatorSource)
+{
+    int next = 0;
+    QList<int> result;
+    Future<long long> future = pipeline::from([&next]() -> std::optional<int> {
+                                   if (next == 100)
+                                       return std::nullopt;
+                                   return next++;
+                               })
+                                   .sink([&result](int x) { result << x; })
+                                   .run();
+    ASSERT_TRUE(future.wait(10000));
+    EXPECT_EQ(100, future.result());
+    ASSERT_EQ(100, result.size());
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(i, result[i]);
+}
+
+TEST(PipelineTest, emptySource)
+{
+    Future<long long> future = pipeline::from(QVector<int>()).stage([](int x) { return x; }).sink([](int) {}).run();
+    ASSERT_TRUE(future.wait(10000));
+    ASSERT_TRUE(future.isSucceeded());
+    EXPECT_EQ(0, future.result());
+}
+
+TEST(PipelineTest, backpressure)
+{
+    std::atomic<long long> produced{0};
+    std::atomic<long long> consumed{0};
+    std::atomic<long long> maxDistance{0};
+    std::atomic_bool sinkAllowed{false};
+    Future<long long> future = pipeline::from([&produced]() -> std::optional<long long> {
+                                   long long value = produced++;
+                                   if (value >= 1000)
+                                       return std::nullopt;
+                                   return value;
+                               })
+                                   .stage([](long long x) { return x; }, 1, tasks::TaskType::Intensive, 4)
+                                   .sink(
+                                       [&consumed, &produced, &maxDistance, &sinkAllowed](long long) {
+                                           while (!sinkAllowed)
+                                               std::this_thread::yield();
+                                           long long distance = produced - (++consumed);
+                                           long long max = maxDistance;
+                                           while (distance > max && !maxDistance.compare_exchange_weak(max, distance))
+                                               ;
+                                       },
+                                       1, tasks::TaskType::Intensive, 4)
+                                   .run();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    // Source can't run further than queue capacities and elements that are being processed at the moment
+    EXPECT_GE(12, produced);
+    EXPECT_FALSE(future.isCompleted());
+    sinkAllowed = true;
+    ASSERT_TRUE(future.wait(10000));
+    EXPECT_EQ(1000, future.result());
+    EXPECT_GE(12, maxDistance);
+}
+
+TEST(PipelineTest, failure)
+{
+    std::vector<int> data;
+    for (int i = 0; i < 1000; ++i)
+        data.push_back(i);
+    std::atomic<int> consumed{0};
+    Future<long long> future = pipeline::from(data)
+                                   .stage(
+                                       [](int x) {
+                                           if (x == 500)
+                                               throw std::runtime_error("failed");
+                                           return x;
+                                       },
+                                       2)
+                                   .sink([&consumed](int) { ++consumed; })
+                                   .run();
+    ASSERT_TRUE(future.wait(10000));
+    ASSERT_TRUE(future.isFailed());
+    EXPECT_EQ("Exception caught: failed", future.failureReason().message);
+    EXPECT_GT(1000, consumed);
+}
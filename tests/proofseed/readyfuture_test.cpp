@@ -0,0 +1,144 @@
+// clazy:skip
+
+#include "proofseed/readyfuture.h"
+
+#include "gtest/proof/test_global.h"
+
+#include <QString>
+
+using namespace Proof;
+
+TEST(ReadyFutureTest, successful)
+{
+    ReadyFuture<int> future = futures::ready(42);
+    EXPECT_TRUE(future.isInline());
+    EXPECT_TRUE(future.isCompleted());
+    EXPECT_TRUE(future.isSucceeded());
+    EXPECT_FALSE(future.isFailed());
+    EXPECT_EQ(42, future.result());
+
+    Future<int> converted = future;
+    ASSERT_TRUE(converted.isSucceeded());
+    EXPECT_EQ(42, converted.result());
+}
+
+TEST(ReadyFutureTest, failed)
+{
+    ReadyFuture<int> future = futures::readyFailure<int>(Failure("failed", 1, 2));
+    EXPECT_TRUE(future.isInline());
+    EXPECT_TRUE(future.isCompleted());
+    EXPECT_TRUE(future.isFailed());
+    EXPECT_EQ("failed", future.failureReason().message);
+
+    Future<int> converted = future.future();
+    ASSERT_TRUE(converted.isFailed());
+    EXPECT_EQ(1, converted.failureReason().moduleCode);
+}
+
+TEST(ReadyFutureTest, mapInline)
+{
+    ReadyFuture<QString> future = futures::ready(21).map([](int x) { return x * 2; }).map([](int x) {
+        return QString::number(x);
+    });
+    EXPECT_TRUE(future.isInline());
+    ASSERT_TRUE(future.isSucceeded());
+    EXPECT_EQ("42", future.result());
+
+    ReadyFuture<int> failed = futures::readyFailure<int>(Failure("failed", 0, 0)).map([](int x) { return x * 2; });
+    EXPECT_TRUE(failed.isInline());
+    ASSERT_TRUE(failed.isFailed());
+    EXPECT_EQ("failed", failed.failureReason().message);
+}
+
+TEST(ReadyFutureTest, mapVoid)
+{
+    int sum = 0;
+    ReadyFuture<bool> future = futures::ready(21).map([&sum](int x) { sum += x; });
+    EXPECT_TRUE(future.isInline());
+    ASSERT_TRUE(future.isSucceeded());
+    EXPECT_TRUE(future.result());
+    EXPECT_EQ(21, sum);
+
+    Promise<int> promise;
+    ReadyFuture<bool> pending = futures::ready(promise.future()).map([&sum](int x) { sum += x; });
+    EXPECT_FALSE(pending.isCompleted());
+    promise.success(21);
+    ASSERT_TRUE(pending.wait(1000));
+    ASSERT_TRUE(pending.isSucceeded());
+    EXPECT_EQ(42, sum);
+}
+
+TEST(ReadyFutureTest, mapException)
+{
+    ReadyFuture<int> future = futures::ready(21).map([](int) -> int { throw std::runtime_error("oops"); });
+    EXPECT_TRUE(future.isInline());
+    ASSERT_TRUE(future.isFailed());
+    EXPECT_EQ("Exception caught: oops", future.failureReason().message);
+}
+
+TEST(ReadyFutureTest, mapPending)
+{
+    Promise<int> promise;
+    ReadyFuture<int> future = futures::ready(promise.future()).map([](int x) { return x * 2; });
+    EXPECT_FALSE(future.isInline());
+    EXPECT_FALSE(future.isCompleted());
+    promise.success(21);
+    ASSERT_TRUE(future.wait(1000));
+    ASSERT_TRUE(future.isSucceeded());
+    EXPECT_EQ(42, future.result());
+}
+
+TEST(ReadyFutureTest, mapCompletedFuture)
+{
+    ReadyFuture<int> future = futures::ready(Future<int>::successful(21)).map([](int x) { return x * 2; });
+    EXPECT_TRUE(future.isInline());
+    EXPECT_EQ(42, future.result());
+}
+
+TEST(ReadyFutureTest, flatMap)
+{
+    ReadyFuture<int> inlineResult = futures::ready(1).flatMap([](int x) { return futures::ready(x + 1); });
+    EXPECT_TRUE(inlineResult.isInline());
+    EXPECT_EQ(2, inlineResult.result());
+
+    Promise<int> promise;
+    ReadyFuture<int> pendingResult = futures::ready(1).flatMap([promise](int) { return promise.future(); });
+    EXPECT_FALSE(pendingResult.isCompleted());
+    promise.success(5);
+    ASSERT_TRUE(pendingResult.wait(1000));
+    EXPECT_EQ(5, pendingResult.result());
+
+    Promise<int> source;
+    ReadyFuture<int> chained = futures::ready(source.future()).flatMap([](int x) { return futures::ready(x * 3); });
+    EXPECT_FALSE(chained.isCompleted());
+    source.success(5);
+    ASSERT_TRUE(chained.wait(1000));
+    EXPECT_EQ(15, chained.result());
+}
+
+TEST(ReadyFutureTest, recover)
+{
+    ReadyFuture<int> recovered = futures::readyFailure<int>(Failure("failed", 0, 0)).recover([](const Failure &f) {
+        return f.message.size();
+    });
+    EXPECT_TRUE(recovered.isInline());
+    ASSERT_TRUE(recovered.isSucceeded());
+    EXPECT_EQ(6, recovered.result());
+
+    ReadyFuture<int> untouched = futures::ready(1).recover([](const Failure &) { return 2; });
+    EXPECT_EQ(1, untouched.result());
+}
+
+TEST(ReadyFutureTest, callbacks)
+{
+    int successCalls = 0;
+    int failureCalls = 0;
+    futures::ready(1)
+        .onSuccess([&successCalls](int) { ++successCalls; })
+        .onFailure([&failureCalls](const Failure &) { ++failureCalls; });
+    futures::readyFailure<int>(Failure("failed", 0, 0))
+        .onSuccess([&successCalls](int) { ++successCalls; })
+        .onFailure([&failureCalls](const Failure &) { ++failureCalls; });
+    EXPECT_EQ(1, successCalls);
+    EXPECT_EQ(1, failureCalls);
+}
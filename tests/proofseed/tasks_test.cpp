@@ -55,6 +55,29 @@ TEST(TasksTest, signalWaiting)
     delete timer;
 }
 
+TEST(TasksTest, signalWaitingWithConvertibleArguments)
+{
+    QObject *object = new QObject;
+    std::atomic_bool ready{false};
+    Future<const QObject *> future = run([object, &ready]() {
+        const QObject *result = nullptr;
+        addSignalWaiter(object, &QObject::destroyed, std::function<bool(const QObject *)>([&result](const QObject *x) {
+                            result = x;
+                            return true;
+                        }));
+        ready = true;
+        fireSignalWaiters();
+        return result;
+    });
+    while (!ready)
+        ;
+    const QObject *expected = object;
+    delete object;
+    future.wait(1000);
+    ASSERT_TRUE(future.isCompleted());
+    EXPECT_EQ(expected, future.result());
+}
+
 TEST(TasksTest, multipleSignalWaiting)
 {
     QThread thread;
@@ -99,3 +122,115 @@ TEST(TasksTest, multipleSignalWaiting)
     thread.wait(100);
     delete timer;
 }
+
+TEST(TasksTest, signalFuture)
+{
+    QThread thread;
+    thread.start();
+    QTimer *timer = new QTimer;
+    timer->setSingleShot(true);
+    timer->moveToThread(&thread);
+    Future<bool> future = signalFuture(timer, &QTimer::timeout);
+    EXPECT_FALSE(future.isCompleted());
+    QMetaObject::invokeMethod(timer, "start", Qt::BlockingQueuedConnection, Q_ARG(int, 1));
+    future.wait(1000);
+    ASSERT_TRUE(future.isCompleted());
+    ASSERT_TRUE(future.isSucceeded());
+    EXPECT_TRUE(future.result());
+    thread.quit();
+    thread.wait(100);
+    delete timer;
+}
+
+TEST(TasksTest, signalFutureWithPredicate)
+{
+    QThread thread;
+    thread.start();
+    std::atomic_int calls{0};
+    QTimer *timer = new QTimer;
+    timer->setSingleShot(true);
+    timer->moveToThread(&thread);
+    Future<bool> future = signalFuture(timer, &QTimer::timeout, std::function<bool()>([&calls]() {
+                                           return ++calls == 2;
+                                       }));
+    QMetaObject::invokeMethod(timer, "start", Qt::BlockingQueuedConnection, Q_ARG(int, 1));
+    while (calls < 1)
+        ;
+    ASSERT_FALSE(future.isCompleted());
+    QMetaObject::invokeMethod(timer, "start", Qt::BlockingQueuedConnection, Q_ARG(int, 1));
+    future.wait(1000);
+    ASSERT_TRUE(future.isCompleted());
+    EXPECT_TRUE(future.isSucceeded());
+    EXPECT_EQ(2, calls);
+    thread.quit();
+    thread.wait(100);
+    delete timer;
+}
+
+TEST(TasksTest, signalFutureWithConvertibleArguments)
+{
+    QObject *object = new QObject;
+    const QObject *seen = nullptr;
+    Future<bool> future = signalFuture(object, &QObject::destroyed,
+                                       std::function<bool(const QObject *)>([&seen](const QObject *x) {
+                                           seen = x;
+                                           return true;
+                                       }));
+    EXPECT_FALSE(future.isCompleted());
+    const QObject *expected = object;
+    delete object;
+    ASSERT_TRUE(future.isCompleted());
+    EXPECT_TRUE(future.isSucceeded());
+    EXPECT_EQ(expected, seen);
+}
+
+TEST(TasksTest, signalFutureTimeout)
+{
+    QThread thread;
+    thread.start();
+    QTimer *timer = new QTimer;
+    timer->moveToThread(&thread);
+    Future<bool> future = signalFuture(timer, &QTimer::timeout, 10);
+    future.wait(1000);
+    ASSERT_TRUE(future.isCompleted());
+    ASSERT_TRUE(future.isFailed());
+    EXPECT_EQ("Signal waiting timeout", future.failureReason().message);
+    thread.quit();
+    thread.wait(100);
+    delete timer;
+}
+
+TEST(TasksTest, signalFutureSenderDestroyed)
+{
+    QTimer *timer = new QTimer;
+    Future<bool> future = signalFuture(timer, &QTimer::timeout);
+    EXPECT_FALSE(future.isCompleted());
+    delete timer;
+    future.wait(1000);
+    ASSERT_TRUE(future.isCompleted());
+    ASSERT_TRUE(future.isFailed());
+    EXPECT_EQ("Signal sender destroyed", future.failureReason().message);
+}
+
+TEST(TasksTest, signalFuturesShareConnection)
+{
+    QThread thread;
+    thread.start();
+    QTimer *timer = new QTimer;
+    timer->setSingleShot(true);
+    timer->moveToThread(&thread);
+    qint64 multiplexersBefore = tasks::detail::SignalWaitersRegistry::multiplexersCount();
+    QVector<Future<bool>> futures;
+    for (int i = 0; i < 100; ++i)
+        futures << signalFuture(timer, &QTimer::timeout);
+    EXPECT_EQ(multiplexersBefore + 1, tasks::detail::SignalWaitersRegistry::multiplexersCount());
+    QMetaObject::invokeMethod(timer, "start", Qt::BlockingQueuedConnection, Q_ARG(int, 1));
+    for (int i = 0; i < 100; ++i) {
+        futures[i].wait(1000);
+        ASSERT_TRUE(futures[i].isSucceeded()) << i;
+    }
+    EXPECT_EQ(multiplexersBefore, tasks::detail::SignalWaitersRegistry::multiplexersCount());
+    thread.quit();
+    thread.wait(100);
+    delete timer;
+}
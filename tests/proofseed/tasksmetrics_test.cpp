@@ -0,0 +1,132 @@
+// clazy:skip
+
+#include "proofseed/asynqro_extra.h"
+#include "proofseed/tasksmetrics.h"
+
+#include "gtest/proof/test_global.h"
+
+#include <QVector>
+
+#include <atomic>
+#include <thread>
+
+using namespace Proof;
+
+namespace {
+tasks::TasksGroupMetrics findGroup(int32_t tag, tasks::TaskPriority priority = tasks::TaskPriority::Regular)
+{
+    for (const auto &group : tasks::TasksMetrics::snapshot()) {
+        if (group.tag == tag && group.priority == priority)
+            return group;
+    }
+    return tasks::TasksGroupMetrics{};
+}
+
+class TasksMetricsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override { tasks::TasksMetrics::setEnabled(true); }
+    void TearDown() override { tasks::TasksMetrics::setEnabled(false); }
+};
+} // namespace
+
+TEST_F(TasksMetricsTest, finishedTasks)
+{
+    const int32_t tag = tasks::USER_MIN_TAG + 1;
+    // Counters are never reset, so only difference is checked
+    const tasks::TasksGroupMetrics before = findGroup(tag);
+    QVector<Future<int>> futures;
+    for (int i = 0; i < 100; ++i)
+        futures << tasks::run([i]() { return i; }, tasks::TaskType::Intensive, tag);
+    for (const auto &f : futures)
+        ASSERT_TRUE(f.wait(10000));
+    // Counters are updated after result is set
+    tasks::TasksGroupMetrics group = findGroup(tag);
+    for (int i = 0; i < 1000 && group.finished - before.finished != 100; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        group = findGroup(tag);
+    }
+    EXPECT_EQ(tasks::TaskType::Intensive, group.type);
+    EXPECT_EQ(tag, group.tag);
+    EXPECT_EQ(100, group.finished - before.finished);
+    EXPECT_EQ(0, group.queued);
+    EXPECT_EQ(0, group.running);
+    EXPECT_EQ(100, group.waitTime.count() - before.waitTime.count());
+    EXPECT_EQ(100, group.execTime.count() - before.execTime.count());
+}
+
+TEST_F(TasksMetricsTest, runningAndQueuedTasks)
+{
+    const int32_t tag = tasks::USER_MIN_TAG + 2;
+    const long long capacity = tasks::Runner::instance()->capacity();
+    const long long finishedBefore = findGroup(tag, tasks::TaskPriority::Background).finished;
+    std::atomic_bool released{false};
+    std::atomic<long long> started{0};
+    for (long long i = 0; i < capacity + 5; ++i) {
+        tasks::runAndForget(
+            [&released, &started]() {
+                ++started;
+                while (!released)
+                    std::this_thread::yield();
+            },
+            tasks::TaskType::Intensive, tag, tasks::TaskPriority::Background);
+    }
+    while (started < capacity)
+        std::this_thread::yield();
+    tasks::TasksGroupMetrics group = findGroup(tag, tasks::TaskPriority::Background);
+    EXPECT_EQ(tasks::TaskPriority::Background, group.priority);
+    EXPECT_EQ(capacity, group.running);
+    EXPECT_EQ(5, group.queued);
+    EXPECT_EQ(finishedBefore, group.finished);
+    released = true;
+    for (int i = 0; i < 1000 && group.finished - finishedBefore != capacity + 5; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        group = findGroup(tag, tasks::TaskPriority::Background);
+    }
+    EXPECT_EQ(capacity + 5, group.finished - finishedBefore);
+    EXPECT_EQ(0, group.running);
+    EXPECT_EQ(0, group.queued);
+}
+
+TEST_F(TasksMetricsTest, windowedRunTasks)
+{
+    const int32_t tag = tasks::USER_MIN_TAG + 4;
+    const long long finishedBefore = findGroup(tag).finished;
+    QVector<int> data;
+    for (int i = 0; i < 50; ++i)
+        data << i;
+    auto future = tasks::windowedRun(data, [](int x) { return x * 2; }, 4, tasks::WindowOrder::Ordered,
+                                     tasks::TaskType::Intensive, tag);
+    ASSERT_TRUE(future.wait(10000));
+    ASSERT_TRUE(future.isSucceeded());
+    // Counters are updated after task is finished
+    tasks::TasksGroupMetrics group = findGroup(tag);
+    for (int i = 0; i < 1000 && group.finished - finishedBefore != 50; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        group = findGroup(tag);
+    }
+    EXPECT_EQ(tag, group.tag);
+    EXPECT_EQ(50, group.finished - finishedBefore);
+}
+
+TEST_F(TasksMetricsTest, disabled)
+{
+    tasks::TasksMetrics::setEnabled(false);
+    const int32_t tag = tasks::USER_MIN_TAG + 3;
+    ASSERT_TRUE(tasks::run([]() { return 42; }, tasks::TaskType::Intensive, tag).wait(10000));
+    for (const auto &group : tasks::TasksMetrics::snapshot())
+        EXPECT_NE(tag, group.tag);
+}
+
+TEST(TasksHistogramTest, percentile)
+{
+    tasks::TasksHistogram histogram;
+    EXPECT_EQ(0, histogram.percentile(50));
+    histogram.buckets[1] = 90;
+    histogram.buckets[10] = 10;
+    EXPECT_EQ(100, histogram.count());
+    EXPECT_EQ(2, histogram.percentile(50));
+    EXPECT_EQ(2, histogram.percentile(89));
+    EXPECT_EQ(1024, histogram.percentile(95));
+    EXPECT_EQ(1024, histogram.percentile(100));
+}
@@ -0,0 +1,141 @@
+// clazy:skip
+
+#include "proofseed/uniquefunction.h"
+
+#include "gtest/proof/test_global.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+using namespace Proof;
+
+namespace {
+struct LifetimeCounter
+{
+    explicit LifetimeCounter(int *alive) : alive(alive) { ++*alive; }
+    LifetimeCounter(const LifetimeCounter &other) : alive(other.alive) { ++*alive; }
+    LifetimeCounter(LifetimeCounter &&other) noexcept : alive(other.alive) { ++*alive; }
+    LifetimeCounter &operator=(const LifetimeCounter &) = delete;
+    LifetimeCounter &operator=(LifetimeCounter &&) = delete;
+    ~LifetimeCounter() { --*alive; }
+    int *alive;
+};
+
+int triple(int x)
+{
+    return x * 3;
+}
+} // namespace
+
+TEST(UniqueFunctionTest, empty)
+{
+    UniqueFunction<int(int)> func;
+    EXPECT_FALSE(func);
+    EXPECT_THROW(func(5), std::bad_function_call);
+    UniqueFunction<int(int)> fromNull = nullptr;
+    EXPECT_FALSE(fromNull);
+    UniqueFunction<int(int)> fromNullPointer = static_cast<int (*)(int)>(nullptr);
+    EXPECT_FALSE(fromNullPointer);
+    UniqueFunction<int(int)> fromEmptyStdFunction = std::function<int(int)>();
+    EXPECT_FALSE(fromEmptyStdFunction);
+    EXPECT_EQ(64u, sizeof(UniqueFunction<int(int)>));
+}
+
+TEST(UniqueFunctionTest, call)
+{
+    UniqueFunction<int(int)> fromPointer = &triple;
+    ASSERT_TRUE(fromPointer);
+    EXPECT_EQ(15, fromPointer(5));
+
+    int base = 10;
+    UniqueFunction<int(int)> fromLambda = [base](int x) { return base + x; };
+    EXPECT_EQ(15, fromLambda(5));
+
+    UniqueFunction<long long(int)> fromStdFunction = std::function<int(int)>(&triple);
+    EXPECT_EQ(21ll, fromStdFunction(7));
+
+    int counter = 0;
+    UniqueFunction<void()> mutableLambda = [counter, &base]() mutable { base = ++counter; };
+    mutableLambda();
+    mutableLambda();
+    EXPECT_EQ(2, base);
+
+    struct Point
+    {
+        int x;
+    };
+    UniqueFunction<int(const Point &)> fromMemberPointer = &Point::x;
+    EXPECT_EQ(42, fromMemberPointer(Point{42}));
+}
+
+TEST(UniqueFunctionTest, moveOnlyCapture)
+{
+    auto value = std::make_unique<int>(42);
+    UniqueFunction<int()> func = [value = std::move(value)]() { return *value; };
+    ASSERT_TRUE(func);
+    EXPECT_EQ(42, func());
+
+    UniqueFunction<int()> moved = std::move(func);
+    EXPECT_FALSE(func);
+    ASSERT_TRUE(moved);
+    EXPECT_EQ(42, moved());
+
+    func = std::move(moved);
+    EXPECT_FALSE(moved);
+    EXPECT_EQ(42, func());
+}
+
+TEST(UniqueFunctionTest, inlineAndHeapStorage)
+{
+    auto small = [x = std::array<char, 32>()]() { return x.size(); };
+    auto big = [x = std::array<char, 256>()]() { return x.size(); };
+    auto huge = [x = std::array<char, 4096>()]() { return x.size(); };
+    EXPECT_TRUE(UniqueFunction<size_t()>::isStoredInline<decltype(small)>);
+    EXPECT_FALSE(UniqueFunction<size_t()>::isStoredInline<decltype(big)>);
+    EXPECT_FALSE(UniqueFunction<size_t()>::isStoredInline<decltype(huge)>);
+
+    MemoryPoolStats before = MemoryPool::stats();
+    UniqueFunction<size_t()> smallFunc = small;
+    MemoryPoolStats afterSmall = MemoryPool::stats();
+    EXPECT_EQ(before.hits + before.misses + before.oversized,
+              afterSmall.hits + afterSmall.misses + afterSmall.oversized);
+    EXPECT_EQ(32u, smallFunc());
+
+    UniqueFunction<size_t()> bigFunc = big;
+    MemoryPoolStats afterBig = MemoryPool::stats();
+    EXPECT_EQ(afterSmall.hits + afterSmall.misses + 1, afterBig.hits + afterBig.misses);
+    EXPECT_EQ(256u, bigFunc());
+
+    UniqueFunction<size_t()> hugeFunc = huge;
+    EXPECT_EQ(afterBig.oversized + 1, MemoryPool::stats().oversized);
+    EXPECT_EQ(4096u, hugeFunc());
+
+    UniqueFunction<size_t()> movedBig = std::move(bigFunc);
+    EXPECT_EQ(256u, movedBig());
+    std::swap(smallFunc, hugeFunc);
+    EXPECT_EQ(4096u, smallFunc());
+    EXPECT_EQ(32u, hugeFunc());
+}
+
+TEST(UniqueFunctionTest, destruction)
+{
+    int alive = 0;
+    {
+        LifetimeCounter counter(&alive);
+        UniqueFunction<void()> inlineFunc = [counter]() {};
+        UniqueFunction<void()> heapFunc = [counter, padding = std::array<char, 128>()]() {};
+        EXPECT_EQ(3, alive);
+
+        UniqueFunction<void()> movedInline = std::move(inlineFunc);
+        UniqueFunction<void()> movedHeap = std::move(heapFunc);
+        EXPECT_EQ(3, alive);
+
+        movedInline = nullptr;
+        EXPECT_EQ(2, alive);
+        movedInline = std::move(movedHeap);
+        EXPECT_EQ(2, alive);
+    }
+    EXPECT_EQ(0, alive);
+}
@@ -0,0 +1,162 @@
+// clazy:skip
+
+#include "proofseed/asynqro_extra.h"
+#include "proofseed/workstealingpool.h"
+
+#include "gtest/proof/test_global.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+using namespace Proof;
+
+TEST(WorkStealingPoolTest, externalProducers)
+{
+    std::atomic<long long> left{40000};
+    Promise<bool> done;
+    tasks::WorkStealingPool pool(4);
+    EXPECT_EQ(4, pool.capacity());
+    EXPECT_FALSE(pool.isWorkerThread());
+    std::vector<std::thread> producers;
+    for (int i = 0; i < 4; ++i) {
+        producers.emplace_back([&pool, &left, done]() {
+            for (int j = 0; j < 10000; ++j) {
+                pool.post([&left, done]() {
+                    if (!--left)
+                        done.success(true);
+                });
+            }
+        });
+    }
+    for (auto &producer : producers)
+        producer.join();
+    ASSERT_TRUE(done.future().wait(10000));
+    EXPECT_EQ(0, left);
+}
+
+TEST(WorkStealingPoolTest, nestedTasks)
+{
+    std::atomic<long long> leaves{0};
+    std::atomic<long long> nonWorkerThreadCalls{0};
+    Promise<bool> done;
+    std::function<void(int)> spawn;
+    // Pool is destroyed first and waits for its workers
+    tasks::WorkStealingPool pool(4);
+    spawn = [&pool, &leaves, &nonWorkerThreadCalls, &spawn, done](int depth) {
+        if (!pool.isWorkerThread())
+            ++nonWorkerThreadCalls;
+        if (!depth) {
+            if (++leaves == 1 << 12)
+                done.success(true);
+            return;
+        }
+        pool.post([&spawn, depth]() { spawn(depth - 1); });
+        pool.post([&spawn, depth]() { spawn(depth - 1); });
+    };
+    pool.post([&spawn]() { spawn(12); });
+    ASSERT_TRUE(done.future().wait(10000));
+    EXPECT_EQ(1 << 12, leaves);
+    EXPECT_EQ(0, nonWorkerThreadCalls);
+}
+
+TEST(WorkStealingPoolTest, stealing)
+{
+    std::mutex lock;
+    std::set<std::thread::id> threads;
+    std::atomic<int> left{64};
+    Promise<bool> done;
+    tasks::WorkStealingPool pool(4);
+    // All tasks are pushed to one worker deque, other workers can get them only by stealing
+    pool.post([&pool, &lock, &threads, &left, done]() {
+        for (int i = 0; i < 64; ++i) {
+            pool.post([&lock, &threads, &left, done]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    threads.insert(std::this_thread::get_id());
+                }
+                if (!--left)
+                    done.success(true);
+            });
+        }
+    });
+    ASSERT_TRUE(done.future().wait(10000));
+    EXPECT_LT(1u, threads.size());
+}
+
+TEST(WorkStealingPoolTest, exceptionsAreIgnored)
+{
+    Promise<bool> done;
+    tasks::WorkStealingPool pool(2);
+    pool.post([]() { throw std::runtime_error("failed"); });
+    pool.post([done]() { done.success(true); });
+    ASSERT_TRUE(done.future().wait(10000));
+}
+
+TEST(WorkStealingPoolTest, runAndForgetScheduling)
+{
+    EXPECT_EQ(tasks::Scheduling::SharedQueue, tasks::WorkStealingPool::scheduling());
+    tasks::WorkStealingPool::setScheduling(tasks::Scheduling::WorkStealing);
+    Promise<bool> intensive;
+    Promise<bool> threadBound;
+    Promise<bool> prioritized;
+    tasks::runAndForget([intensive]() { intensive.success(tasks::WorkStealingPool::instance()->isWorkerThread()); });
+    tasks::runAndForget([threadBound]() { threadBound.success(tasks::WorkStealingPool::instance()->isWorkerThread()); },
+                        tasks::TaskType::ThreadBound, 42);
+    tasks::runAndForget([prioritized]() { prioritized.success(tasks::WorkStealingPool::instance()->isWorkerThread()); },
+                        tasks::TaskType::Intensive, 0, tasks::TaskPriority::Emergency);
+    tasks::WorkStealingPool::setScheduling(tasks::Scheduling::SharedQueue);
+    ASSERT_TRUE(intensive.future().wait(10000));
+    ASSERT_TRUE(threadBound.future().wait(10000));
+    ASSERT_TRUE(prioritized.future().wait(10000));
+    EXPECT_TRUE(intensive.future().result());
+    EXPECT_FALSE(threadBound.future().result());
+    EXPECT_FALSE(prioritized.future().result());
+}
+
+TEST(WorkStealingPoolTest, runScheduling)
+{
+    EXPECT_EQ(tasks::Runner::instance()->capacity(), tasks::WorkStealingPool::instance()->capacity());
+    tasks::WorkStealingPool::setScheduling(tasks::Scheduling::WorkStealing);
+    auto stolen = tasks::run([]() { return tasks::WorkStealingPool::instance()->isWorkerThread(); });
+    auto stolenVoid = tasks::run([]() {});
+    auto stolenFailure = tasks::run([]() -> int { throw std::runtime_error("boom"); });
+    auto prioritized = tasks::run([]() { return tasks::WorkStealingPool::instance()->isWorkerThread(); },
+                                  tasks::TaskType::Intensive, 0, tasks::TaskPriority::Background);
+    tasks::WorkStealingPool::setScheduling(tasks::Scheduling::SharedQueue);
+    ASSERT_TRUE(stolen.wait(10000));
+    ASSERT_TRUE(stolenVoid.wait(10000));
+    ASSERT_TRUE(stolenFailure.wait(10000));
+    ASSERT_TRUE(prioritized.wait(10000));
+    EXPECT_TRUE(stolen.result());
+    EXPECT_TRUE(stolenVoid.result());
+    EXPECT_TRUE(stolenFailure.isFailed());
+    EXPECT_FALSE(prioritized.result());
+}
+
+TEST(WorkStealingPoolTest, clusteredRunScheduling)
+{
+    std::vector<int> data;
+    for (int i = 0; i < 1000; ++i)
+        data.push_back(i);
+    tasks::WorkStealingPool::setScheduling(tasks::Scheduling::WorkStealing);
+    auto stolen = tasks::clusteredRun(data, [](int x) { return x * 2; }, 10);
+    auto stolenFailure = tasks::clusteredRun(data, [](int x) {
+        if (x == 500)
+            throw std::runtime_error("boom");
+        return x;
+    });
+    tasks::WorkStealingPool::setScheduling(tasks::Scheduling::SharedQueue);
+    ASSERT_TRUE(stolen.wait(10000));
+    ASSERT_TRUE(stolenFailure.wait(10000));
+    ASSERT_TRUE(stolen.isSucceeded());
+    auto result = stolen.result();
+    ASSERT_EQ(data.size(), result.size());
+    for (size_t i = 0; i < result.size(); ++i)
+        EXPECT_EQ(data[i] * 2, result[i]) << i;
+    EXPECT_TRUE(stolenFailure.isFailed());
+}